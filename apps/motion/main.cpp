@@ -109,22 +109,12 @@ static void stop(struct data *d);
 
 URT_GLUE(start, body, stop, struct data, interrupted, done)
 
+/* allocated by skin along with the sensors, and zero-initialized */
 struct sensor_extra_data
 {
 	skin_sensor_calibration_info calib_info;
-	sensor_extra_data(): calib_info({0}) {}
 };
 
-static void sensor_init_hook(SkinSensor s)
-{
-	s.setUserData(new struct sensor_extra_data);
-}
-
-static void sensor_clean_hook(SkinSensor s)
-{
-	delete (struct sensor_extra_data *)s.getUserData();
-}
-
 static struct skin_sensor_calibration_info *get_calib_info(struct skin_sensor *s, void *user_data)
 {
 	struct sensor_extra_data *extra_data = (struct sensor_extra_data *)s->user_data;
@@ -431,8 +421,7 @@ static int start(struct data *d)
 	if (d->skin.init())
 		goto exit_no_skin;
 
-	d->skin.setSensorInitHook(sensor_init_hook);
-	d->skin.setSensorCleanHook(sensor_clean_hook);
+	d->skin.setSensorDataSize(sizeof(struct sensor_extra_data));
 
 	return 0;
 exit_no_skin:
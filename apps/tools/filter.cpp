@@ -100,33 +100,22 @@ void filter::new_responses(const vector<uint8_t> &v)
 	}
 }
 
-struct store_responses_data
+void filter::new_responses(struct skin *skin)
 {
+	vector<skin_sensor_response> r(skin_sensor_count(skin));
 	vector<uint8_t> v;
-	unsigned int type_sensors_begin;
-};
-
-static int _store_responses(skin_sensor *s, void *d)
-{
-	store_responses_data *data = (store_responses_data *)d;
-
-	data->v[s->id - data->type_sensors_begin] = (uint32_t)skin_sensor_get_response(s) * 255 / SKIN_SENSOR_RESPONSE_MAX;
-	return SKIN_CALLBACK_CONTINUE;
-}
 
+	if (!r.empty())
+		r.resize(skin_get_responses(skin, &r[0], r.size()));
+	v.resize(r.size());
+	if (!r.empty())
+		skin_responses_to_u8(&v[0], &r[0], r.size());
 
-void filter::new_responses(struct skin *skin)
-{
-	store_responses_data d;
-	d.v.resize(skin_sensor_count(skin));
-	d.type_sensors_begin = 0;
-
-	skin_for_each_sensor(skin, _store_responses, &d);
 	if (responses.size() < size)
 		while (responses.size() < size)
-			responses.push_back(d.v);
+			responses.push_back(v);
 	else
-		responses[current] = d.v;
+		responses[current] = v;
 }
 
 uint8_t filter::get_response(skin_sensor_id id) const
@@ -190,28 +190,13 @@ void scaler::scale(struct skin *skin, vector<uint8_t> &result)
 	skin_for_each_sensor(skin, _fix_responses, &data);
 }
 
-struct store_responses_data
-{
-	vector<skin_sensor_response> v;
-	unsigned int type_sensors_begin;
-};
-
-static int _store_responses(skin_sensor *s, void *d)
-{
-	store_responses_data *data = (store_responses_data *)d;
-
-	data->v[s->id - data->type_sensors_begin] = skin_sensor_get_response(s);
-	return SKIN_CALLBACK_CONTINUE;
-}
-
 vector<uint8_t> scaler::scale(struct skin *skin)
 {
-	store_responses_data d;
-	d.v.resize(skin_sensor_count(skin));
-	d.type_sensors_begin = 0;
+	vector<skin_sensor_response> v(skin_sensor_count(skin));
 
-	skin_for_each_sensor(skin, _store_responses, &d);
-	return scale(d.v);
+	if (!v.empty())
+		v.resize(skin_get_responses(skin, &v[0], v.size()));
+	return scale(v);
 }
 
 void scaler::dampen(unsigned int amount)
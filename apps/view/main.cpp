@@ -213,22 +213,12 @@ void initialize_SDL()
 	SDL_ShowCursor(SDL_DISABLE);
 }
 
+/* allocated by skin along with the sensors, and zero-initialized */
 struct sensor_extra_data
 {
 	struct skin_sensor_calibration_info calib_info;
 };
 
-static void sensor_init_hook(struct skin_sensor *s, void *user_data)
-{
-	s->user_data = urt_mem_new(sizeof(struct sensor_extra_data));
-	*(struct sensor_extra_data *)s->user_data = (struct sensor_extra_data){0};
-}
-
-static void sensor_clean_hook(struct skin_sensor *s, void *user_data)
-{
-	urt_mem_delete(s->user_data);
-}
-
 static struct skin_sensor_calibration_info *get_calib_info(struct skin_sensor *s, void *user_data)
 {
 	struct sensor_extra_data *extra_data = (struct sensor_extra_data *)s->user_data;
@@ -1614,8 +1604,10 @@ static int start(struct data *d)
 		goto exit_no_statout;
 #endif
 
-	skin_set_sensor_init_hook(skin, sensor_init_hook);
-	skin_set_sensor_clean_hook(skin, sensor_clean_hook);
+	skin_set_sensor_data_size(skin, sizeof(struct sensor_extra_data));
+
+	/* in soft acquisition mode, read all drivers with a couple of workers instead of a task for each (if possible) */
+	skin_set_soft_reader_pool(skin, 2, NULL);
 
 	return 0;
 #ifdef TODO_IMPL_SAVE_STAT
@@ -32,6 +32,7 @@
 #include "skin_base.hpp"
 #include "skin_writer.hpp"
 #include "skin_reader.hpp"
+#include "skin_reader_group.hpp"
 #include "skin_driver.hpp"
 #include "skin_user.hpp"
 
@@ -43,5 +44,6 @@
 
 /* misc */
 #include "skin_sensor_types.hpp"
+#include "skin_histogram.hpp"
 
 #endif
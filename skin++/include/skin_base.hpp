@@ -33,6 +33,7 @@
 #include "skin_callbacks.hpp"
 #include "skin_writer.hpp"
 #include "skin_reader.hpp"
+#include "skin_reader_group.hpp"
 #include "skin_driver.hpp"
 #include "skin_user.hpp"
 
@@ -69,6 +70,8 @@ public:
 	SkinReader attach(const SkinReaderAttr &attr, const urt_task_attr &taskAttr,
 			const SkinReaderCallbacks &callbacks, int *error = NULL);
 	void detach(SkinReader &reader) { skin_service_detach(reader.reader); }
+	SkinReaderGroup add(const urt_task_attr &taskAttr, const SkinReaderGroupCallbacks &callbacks, int *error = NULL);
+	void remove(SkinReaderGroup &group) { skin_reader_group_remove(group.group); }
 
 	/* drivers */
 	SkinDriver add(const SkinDriverAttr &attr, const SkinWriterAttr &writerAttr, const urt_task_attr &taskAttr,
@@ -82,6 +85,11 @@ public:
 	int load(const urt_task_attr &taskAttr) { return skin_load(skin, &taskAttr); }
 	void unload() { skin_unload(skin); }
 	int update(const urt_task_attr &taskAttr) { return skin_update(skin, &taskAttr); }
+	void setSensorDataSize(size_t size) { skin_set_sensor_data_size(skin, size); }
+	void setContiguousResponses(bool contiguous) { skin_set_contiguous_responses(skin, contiguous); }
+	void setReaderGroup(SkinReaderGroup &group) { skin_set_reader_group(skin, group.group); }
+	void unsetReaderGroup() { skin_set_reader_group(skin, NULL); }
+	int setSoftReaderPool(unsigned int workerCount, const urt_task_attr *taskAttr = NULL) { return skin_set_soft_reader_pool(skin, workerCount, taskAttr); }
 
 	void pause() { skin_pause(skin); }
 	void resume() { skin_resume(skin); }
@@ -93,10 +101,12 @@ public:
 	size_t readerCount() { return skin_reader_count(skin); }
 	size_t driverCount() { return skin_driver_count(skin); }
 	size_t userCount() { return skin_user_count(skin); }
+	size_t readerGroupCount() { return skin_reader_group_count(skin); }
 	SkinSensorSize sensorCount() { return skin_sensor_count(skin); }
 	SkinModuleSize moduleCount() { return skin_module_count(skin); }
 	SkinPatchSize patchCount() { return skin_patch_count(skin); }
 	SkinSensorTypeSize sensorTypeCount() { return skin_sensor_type_count(skin); }
+	SkinSensorSize getResponses(SkinSensorResponse *responses, SkinSensorSize count) { return skin_get_responses(skin, responses, count); }
 
 	/* hooks */
 	void setWriterInitHook(SkinHook<SkinWriter> hook);
@@ -113,6 +123,12 @@ public:
 	void setModuleCleanHook(SkinHook<SkinModule> hook);
 	void setPatchInitHook(SkinHook<SkinPatch> hook);
 	void setPatchCleanHook(SkinHook<SkinPatch> hook);
+	void setSensorBatchInitHook(SkinHook<SkinSensorSpan> hook);
+	void setSensorBatchCleanHook(SkinHook<SkinSensorSpan> hook);
+	void setModuleBatchInitHook(SkinHook<SkinModuleSpan> hook);
+	void setModuleBatchCleanHook(SkinHook<SkinModuleSpan> hook);
+	void setPatchBatchInitHook(SkinHook<SkinPatchSpan> hook);
+	void setPatchBatchCleanHook(SkinHook<SkinPatchSpan> hook);
 
 	int forEachWriter(SkinCallback<SkinWriter> callback);
 	int forEachReader(SkinCallback<SkinReader> callback);
@@ -144,6 +160,12 @@ public:
 	SkinHook<SkinModule> moduleCleanHook;
 	SkinHook<SkinPatch> patchInitHook;
 	SkinHook<SkinPatch> patchCleanHook;
+	SkinHook<SkinSensorSpan> sensorBatchInitHook;
+	SkinHook<SkinSensorSpan> sensorBatchCleanHook;
+	SkinHook<SkinModuleSpan> moduleBatchInitHook;
+	SkinHook<SkinModuleSpan> moduleBatchCleanHook;
+	SkinHook<SkinPatchSpan> patchBatchInitHook;
+	SkinHook<SkinPatchSpan> patchBatchCleanHook;
 };
 
 #endif
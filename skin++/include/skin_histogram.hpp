@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SKIN_HISTOGRAM_HPP
+#define SKIN_HISTOGRAM_HPP
+
+#include <skin_histogram.h>
+#include "skin_types.hpp"
+
+class SkinHistogram
+{
+public:
+	SkinHistogram(): hist() {}
+	SkinHistogram(const SkinHistogram &) = default;
+	SkinHistogram &operator =(const SkinHistogram &) = default;
+	SkinHistogram(const struct skin_histogram &h): hist(h) {}
+	SkinHistogram &operator =(const struct skin_histogram &h)
+	{
+		hist = h;
+		return *this;
+	}
+
+	uint64_t getTotal() const { return hist.total; }
+	uint64_t getCount(unsigned int bucket) const { return bucket < SKIN_HISTOGRAM_BUCKET_COUNT?hist.counts[bucket]:0; }
+	urt_time percentile(uint32_t p) const { return skin_histogram_percentile(&hist, p); }
+	void record(urt_time value) { skin_histogram_record(&hist, value); }
+
+	static unsigned int bucketCount() { return SKIN_HISTOGRAM_BUCKET_COUNT; }
+	static urt_time bucketLow(unsigned int bucket) { return skin_histogram_bucket_low(bucket); }
+	static urt_time bucketHigh(unsigned int bucket) { return skin_histogram_bucket_high(bucket); }
+
+	/* internal */
+	struct skin_histogram hist;
+};
+
+#endif
@@ -26,14 +26,45 @@
 #define SKIN_HOOKS_HPP
 
 #include <functional>
+#include <cstddef>
 
 /*
  * this file contains callback definitions for Skin::set**Hook functions.
  *
- * Each of these callbacks gets a reference to an object.
+ * Each of these callbacks gets a reference to an object.  The batch hooks
+ * get a span over all sensors, modules or patches of a user.
  */
 
 template<class Object>
 using SkinHook = std::function<void (Object)>;
 
+class Skin;
+class SkinSensor;
+class SkinModule;
+class SkinPatch;
+
+/* a span of consecutive objects, whose wrappers are only created when accessed */
+template<class Object, class CObject>
+class SkinSpan
+{
+public:
+	SkinSpan(CObject *o, size_t c, Skin *s): objects(o), count(c), skin(s) {}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	Object operator [](size_t i) const { return Object(objects + i, skin); }
+
+	/* direct access to the underlying objects, for bulk processing */
+	CObject *data() const { return objects; }
+
+	/* internal */
+	CObject *objects;
+	size_t count;
+	Skin *skin;
+};
+
+typedef SkinSpan<SkinSensor, struct skin_sensor> SkinSensorSpan;
+typedef SkinSpan<SkinModule, struct skin_module> SkinModuleSpan;
+typedef SkinSpan<SkinPatch, struct skin_patch> SkinPatchSpan;
+
 #endif
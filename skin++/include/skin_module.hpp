@@ -46,6 +46,8 @@ public:
 
 	SkinSensorSize sensorCount() { return skin_module_sensor_count(module); }
 
+	SkinResponseSpan getResponseSpan() { return skin_module_get_response_span(module); }
+
 	SkinPatch getPatch() { return SkinPatch(skin_module_get_patch(module), skin); }
 	SkinUser getUser() { return SkinUser(module->user, skin); }
 	Skin &getSkin() { return *skin; }
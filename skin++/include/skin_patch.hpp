@@ -46,6 +46,8 @@ public:
 	SkinSensorSize sensorCount() { return skin_patch_sensor_count(patch); }
 	SkinModuleSize moduleCount() { return skin_patch_module_count(patch); }
 
+	SkinResponseSpan getResponseSpan() { return skin_patch_get_response_span(patch); }
+
 	SkinUser getUser() { return SkinUser(patch->user, skin); }
 	Skin &getSkin() { return *skin; }
 
@@ -28,16 +28,21 @@
 #include <functional>
 #include <skin_reader.h>
 #include "skin_types.hpp"
+#include "skin_histogram.hpp"
 
 class SkinReader;
+class SkinReaderGroup;
 class SkinUser;
 
 class SkinReaderAttr
 {
 public:
-	SkinReaderAttr(const char *name)
+	SkinReaderAttr(const char *name, bool lossless = false, bool pull = false, bool phaseLocked = false)
 	{
 		attr.name = name;
+		attr.lossless = lossless;
+		attr.pull = pull;
+		attr.phase_locked = phaseLocked;
 	}
 	SkinReaderAttr(const struct skin_reader_attr &a)
 	{
@@ -45,6 +50,9 @@ public:
 	}
 
 	const char *getName() { return attr.name; }
+	bool isLossless() { return attr.lossless; }
+	bool isPull() { return attr.pull; }
+	bool isPhaseLocked() { return attr.phase_locked; }
 
 	/* internal */
 	struct skin_reader_attr attr;
@@ -73,6 +81,12 @@ public:
 	urt_time bestWriteTime;
 	urt_time accumulatedWriteTime;
 	uint64_t readCount;
+	uint64_t framesDropped;
+	uint64_t framesMissed;
+	uint64_t staleWakeups;
+	uint64_t lockRetries;
+	SkinHistogram readTimes;
+	SkinHistogram latencies;
 
 	SkinReaderStatistics() = default;
 	SkinReaderStatistics(const SkinReaderStatistics &) = default;
@@ -88,6 +102,10 @@ public:
 		bestWriteTime = stats.best_read_time;
 		accumulatedWriteTime = stats.accumulated_read_time;
 		readCount = stats.read_count;
+		framesDropped = stats.frames_dropped;
+		framesMissed = stats.frames_missed;
+		staleWakeups = stats.stale_wakeups;
+		lockRetries = stats.lock_retries;
 		return *this;
 	}
 };
@@ -124,8 +142,28 @@ public:
 	{
 		struct skin_reader_statistics stats;
 		skin_reader_get_statistics(reader, &stats);
-		return stats;
+		SkinReaderStatistics s = stats;
+		s.readTimes = getHistogram(SKIN_READER_HISTOGRAM_READ_TIME);
+		s.latencies = getHistogram(SKIN_READER_HISTOGRAM_LATENCY);
+		return s;
 	}
+	SkinHistogram getHistogram(int type)
+	{
+		struct skin_histogram hist = {0};
+		skin_reader_get_histogram(reader, type, &hist);
+		return hist;
+	}
+	uint64_t getFrameNumber() { return skin_reader_get_frame_number(reader); }
+
+	int readLatest(urt_time timeout) { return skin_reader_read_latest(reader, timeout); }
+	int waitNew(urt_time timeout) { return skin_reader_wait_new(reader, timeout); }
+
+	int getNotifyFd(int *error = NULL) { return skin_reader_get_notify_fd(reader, error); }
+	int clearNotification() { return skin_reader_clear_notification(reader); }
+
+	int joinGroup(SkinReaderGroup &group);
+	int leaveGroup() { return skin_reader_leave_group(reader); }
+	SkinReaderGroup getGroup();
 
 	/* internal */
 	SkinReader(struct skin_reader *r, Skin *s): reader(r), skin(s) {}
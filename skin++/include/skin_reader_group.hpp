@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SKIN_READER_GROUP_HPP
+#define SKIN_READER_GROUP_HPP
+
+#include <functional>
+#include <skin_reader_group.h>
+#include "skin_types.hpp"
+
+class SkinReaderGroup;
+
+class SkinReaderGroupCallbacks
+{
+public:
+	typedef std::function<void (SkinReaderGroup &)> readCallback;
+	typedef std::function<void (SkinReaderGroup &)> initCallback;
+	typedef std::function<void (SkinReaderGroup &)> cleanCallback;
+	SkinReaderGroupCallbacks(readCallback rc = NULL, initCallback ic = NULL, cleanCallback cc = NULL):
+		read(rc), init(ic), clean(cc) {}
+
+	/* internal */
+	readCallback read;
+	initCallback init;
+	cleanCallback clean;
+};
+
+class Skin;
+
+class SkinReaderGroup
+{
+public:
+	SkinReaderGroup(): group(NULL), skin(NULL) {}
+	SkinReaderGroup(const SkinReaderGroup &) = default;
+	SkinReaderGroup &operator =(const SkinReaderGroup &) = default;
+
+	bool isValid() { return group != NULL && skin != NULL; }
+
+	int pause() { return skin_reader_group_pause(group); }
+	int resume() { return skin_reader_group_resume(group); }
+	bool isPaused() { return skin_reader_group_is_paused(group); }
+	size_t readerCount() { return skin_reader_group_reader_count(group); }
+
+	Skin &getSkin() { return *skin; }
+
+	/* internal */
+	SkinReaderGroup(struct skin_reader_group *g, Skin *s): group(g), skin(s) {}
+
+	struct skin_reader_group *group;
+	Skin *skin;
+};
+
+#endif
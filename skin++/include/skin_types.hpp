@@ -42,5 +42,6 @@ typedef SkinPatchId SkinPatchSize;
 /* other */
 typedef skin_sensor_unique_id SkinSensorUniqueId;
 typedef skin_sensor_response SkinSensorResponse;
+typedef skin_response_span SkinResponseSpan;
 
 #endif
@@ -36,9 +36,11 @@ class SkinUser;
 class SkinUserAttr
 {
 public:
-	SkinUserAttr(SkinSensorTypeId sensorType)
+	SkinUserAttr(SkinSensorTypeId sensorType, size_t sensorDataSize = 0, bool contiguousResponses = false)
 	{
 		attr.sensor_type = sensorType;
+		attr.sensor_data_size = sensorDataSize;
+		attr.contiguous_responses = contiguousResponses;
 	}
 	SkinUserAttr(const struct skin_user_attr &a)
 	{
@@ -46,6 +48,8 @@ public:
 	}
 
 	SkinSensorTypeId getSensorType() { return attr.sensor_type; }
+	size_t getSensorDataSize() { return attr.sensor_data_size; }
+	bool hasContiguousResponses() { return attr.contiguous_responses; }
 
 	/* internal */
 	struct skin_user_attr attr;
@@ -93,9 +97,14 @@ public:
 	bool isActive() { return skin_user_is_active(user); }
 
 	SkinReader getReader() { return SkinReader(skin_user_get_reader(user), skin); }
+	const SkinSensorResponse *getResponses() { return skin_user_get_responses(user); }
+	SkinResponseSpan getResponseSpan() { return skin_user_get_response_span(user); }
+	SkinResponseSpan getResponseSpanOfType(SkinSensorTypeId type) { return skin_user_get_response_span_of_type(user, type); }
+	const SkinSensorId *getSensorsOfType(SkinSensorTypeId type, SkinSensorSize *count) { return skin_user_get_sensors_of_type(user, type, count); }
 	Skin &getSkin() { return *skin; }
 
 	SkinSensorSize sensorCount() { return skin_user_sensor_count(user); }
+	SkinSensorSize sensorOffset() { return skin_user_sensor_offset(user); }
 	SkinModuleSize moduleCount() { return skin_user_module_count(user); }
 	SkinPatchSize patchCount() { return skin_user_patch_count(user); }
 	SkinSensorTypeSize sensorTypeCount() { return skin_user_sensor_type_count(user); }
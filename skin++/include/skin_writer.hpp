@@ -28,6 +28,7 @@
 #include <functional>
 #include <skin_writer.h>
 #include "skin_types.hpp"
+#include "skin_histogram.hpp"
 
 class SkinWriter;
 class SkinDriver;
@@ -35,11 +36,13 @@ class SkinDriver;
 class SkinWriterAttr
 {
 public:
-	SkinWriterAttr(size_t bufferSize, uint8_t bufferCount, const char *name)
+	SkinWriterAttr(size_t bufferSize, uint8_t bufferCount, const char *name, bool lockFree = false, uint32_t history = 0)
 	{
 		attr.buffer_size = bufferSize;
 		attr.buffer_count = bufferCount;
 		attr.name = name;
+		attr.lock_free = lockFree;
+		attr.history = history;
 	}
 	SkinWriterAttr(const struct skin_writer_attr &a)
 	{
@@ -49,6 +52,8 @@ public:
 	size_t getBufferSize() { return attr.buffer_size; }
 	uint8_t getBufferCount() { return attr.buffer_count; }
 	const char *getName() { return attr.name; }
+	bool isLockFree() { return attr.lock_free; }
+	uint32_t getHistory() { return attr.history; }
 
 	/* internal */
 	struct skin_writer_attr attr;
@@ -78,6 +83,9 @@ public:
 	urt_time accumulatedWriteTime;
 	uint64_t writeCount;
 	uint64_t swapSkips;
+	uint64_t swapCount;
+	urt_time swapBudget;
+	SkinHistogram writeTimes;
 
 	SkinWriterStatistics() = default;
 	SkinWriterStatistics(const SkinWriterStatistics &) = default;
@@ -94,6 +102,8 @@ public:
 		accumulatedWriteTime = stats.accumulated_write_time;
 		writeCount = stats.write_count;
 		swapSkips = stats.swap_skips;
+		swapCount = stats.swap_count;
+		swapBudget = stats.swap_budget;
 		return *this;
 	}
 };
@@ -130,7 +140,15 @@ public:
 	{
 		struct skin_writer_statistics stats;
 		skin_writer_get_statistics(writer, &stats);
-		return stats;
+		SkinWriterStatistics s = stats;
+		s.writeTimes = getHistogram();
+		return s;
+	}
+	SkinHistogram getHistogram()
+	{
+		struct skin_histogram hist = {0};
+		skin_writer_get_histogram(writer, &hist);
+		return hist;
 	}
 
 	void copyLastBuffer() { skin_writer_copy_last_buffer(writer); }
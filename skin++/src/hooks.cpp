@@ -50,6 +50,24 @@ DEFINE_HOOK_FUNCS(sensor, Sensor)
 DEFINE_HOOK_FUNCS(module, Module)
 DEFINE_HOOK_FUNCS(patch, Patch)
 
+#define DEFINE_BATCH_HOOK_FUNCS(object, Object, size)					\
+static void object##BatchInit(struct skin_##object *objects, size count, void *userData)	\
+{											\
+	Skin *skin = (Skin *)userData;							\
+	if (skin->object##BatchInitHook)						\
+		skin->object##BatchInitHook(Skin##Object##Span(objects, count, skin));	\
+}											\
+static void object##BatchClean(struct skin_##object *objects, size count, void *userData)	\
+{											\
+	Skin *skin = (Skin *)userData;							\
+	if (skin->object##BatchCleanHook)						\
+		skin->object##BatchCleanHook(Skin##Object##Span(objects, count, skin));	\
+}
+
+DEFINE_BATCH_HOOK_FUNCS(sensor, Sensor, skin_sensor_size)
+DEFINE_BATCH_HOOK_FUNCS(module, Module, skin_module_size)
+DEFINE_BATCH_HOOK_FUNCS(patch, Patch, skin_patch_size)
+
 void Skin::setWriterInitHook(SkinHook<SkinWriter> hook)
 {
 	writerInitHook = hook;
@@ -133,3 +151,39 @@ void Skin::setPatchCleanHook(SkinHook<SkinPatch> hook)
 	patchCleanHook = hook;
 	skin_set_patch_clean_hook(skin, patchClean, this);
 }
+
+void Skin::setSensorBatchInitHook(SkinHook<SkinSensorSpan> hook)
+{
+	sensorBatchInitHook = hook;
+	skin_set_sensor_batch_init_hook(skin, sensorBatchInit, this);
+}
+
+void Skin::setSensorBatchCleanHook(SkinHook<SkinSensorSpan> hook)
+{
+	sensorBatchCleanHook = hook;
+	skin_set_sensor_batch_clean_hook(skin, sensorBatchClean, this);
+}
+
+void Skin::setModuleBatchInitHook(SkinHook<SkinModuleSpan> hook)
+{
+	moduleBatchInitHook = hook;
+	skin_set_module_batch_init_hook(skin, moduleBatchInit, this);
+}
+
+void Skin::setModuleBatchCleanHook(SkinHook<SkinModuleSpan> hook)
+{
+	moduleBatchCleanHook = hook;
+	skin_set_module_batch_clean_hook(skin, moduleBatchClean, this);
+}
+
+void Skin::setPatchBatchInitHook(SkinHook<SkinPatchSpan> hook)
+{
+	patchBatchInitHook = hook;
+	skin_set_patch_batch_init_hook(skin, patchBatchInit, this);
+}
+
+void Skin::setPatchBatchCleanHook(SkinHook<SkinPatchSpan> hook)
+{
+	patchBatchCleanHook = hook;
+	skin_set_patch_batch_clean_hook(skin, patchBatchClean, this);
+}
@@ -25,6 +25,7 @@
 #define URT_LOG_PREFIX "skin++: "
 #include <skin_writer.hpp>
 #include <skin_reader.hpp>
+#include <skin_reader_group.hpp>
 #include <skin_driver.hpp>
 #include <skin_user.hpp>
 
@@ -37,3 +38,13 @@ SkinUser SkinReader::getUser()
 {
 	return SkinUser(skin_reader_get_user(reader), skin);
 }
+
+int SkinReader::joinGroup(SkinReaderGroup &group)
+{
+	return skin_reader_join_group(reader, group.group);
+}
+
+SkinReaderGroup SkinReader::getGroup()
+{
+	return SkinReaderGroup(skin_reader_get_group(reader), skin);
+}
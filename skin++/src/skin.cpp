@@ -42,6 +42,14 @@ public:
 	Skin *skin;
 };
 
+class ReaderGroupCallbacksWithSkin
+{
+public:
+	ReaderGroupCallbacksWithSkin(const SkinReaderGroupCallbacks &c, Skin *s): callbacks(c), skin(s) {}
+	SkinReaderGroupCallbacks callbacks;
+	Skin *skin;
+};
+
 class DriverCallbacksWithSkin
 {
 public:
@@ -106,6 +114,31 @@ static void readerClean(struct skin_reader *reader, void *userData)
 	delete callbacks;
 }
 
+static void readerGroupRead(struct skin_reader_group *group, void *userData)
+{
+	auto callbacks = (ReaderGroupCallbacksWithSkin *)userData;
+	SkinReaderGroup g(group, callbacks->skin);
+	if (callbacks->callbacks.read)
+		callbacks->callbacks.read(g);
+}
+
+static void readerGroupInit(struct skin_reader_group *group, void *userData)
+{
+	auto callbacks = (ReaderGroupCallbacksWithSkin *)userData;
+	SkinReaderGroup g(group, callbacks->skin);
+	if (callbacks->callbacks.init)
+		callbacks->callbacks.init(g);
+}
+
+static void readerGroupClean(struct skin_reader_group *group, void *userData)
+{
+	auto callbacks = (ReaderGroupCallbacksWithSkin *)userData;
+	SkinReaderGroup g(group, callbacks->skin);
+	if (callbacks->callbacks.clean)
+		callbacks->callbacks.clean(g);
+	delete callbacks;
+}
+
 static int driverDetails(struct skin_driver *driver, bool revived, struct skin_driver_details *details, void *userData)
 {
 	auto callbacks = (DriverCallbacksWithSkin *)userData;
@@ -230,6 +263,23 @@ SkinReader Skin::attach(const SkinReaderAttr &attr, const urt_task_attr &taskAtt
 	return SkinReader(reader, this);
 }
 
+SkinReaderGroup Skin::add(const urt_task_attr &taskAttr, const SkinReaderGroupCallbacks &callbacks, int *error)
+{
+	auto extra = new ReaderGroupCallbacksWithSkin(callbacks, this);
+	struct skin_reader_group_callbacks c = {
+		readerGroupRead,
+		readerGroupInit,
+		readerGroupClean,
+		extra,
+	};
+
+	struct skin_reader_group *group = skin_reader_group_add(skin, &taskAttr, &c, error);
+	if (group == NULL)
+		return SkinReaderGroup();
+
+	return SkinReaderGroup(group, this);
+}
+
 SkinDriver Skin::add(const SkinDriverAttr &attr, const SkinWriterAttr &writerAttr, const urt_task_attr &taskAttr,
 		const SkinDriverCallbacks &callbacks, int *error)
 {
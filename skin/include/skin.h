@@ -36,6 +36,7 @@
 #include "skin_base.h"
 #include "skin_writer.h"
 #include "skin_reader.h"
+#include "skin_reader_group.h"
 #include "skin_driver.h"
 #include "skin_user.h"
 
@@ -47,5 +48,10 @@
 
 /* misc */
 #include "skin_sensor_types.h"
+#include "skin_histogram.h"
+#include "skin_snapshot.h"
+#ifndef __KERNEL__
+# include "skin_responses.h"
+#endif
 
 #endif
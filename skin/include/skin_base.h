@@ -30,6 +30,7 @@
 #include "skin_hooks.h"
 #include "skin_writer.h"
 #include "skin_reader.h"
+#include "skin_reader_group.h"
 #include "skin_driver.h"
 #include "skin_user.h"
 
@@ -72,6 +73,10 @@ URT_DECL_BEGIN
  *				its task_attr.  If period is set, it becomes periodic, otherwise if soft is not set it
  *				becomes sporadic, otherwise it will be soft real-time and triggered by writer.
  * service_detach		stop a service reader and detach it from the writer.
+ *   Reader groups:
+ * reader_group_add		create a reader group, whose task reads all the readers that join it in one go.
+ *				task_attr contains the real-time task attributes, which must be periodic.
+ * reader_group_remove		stop a reader group.  Its readers leave the group, but are otherwise left intact.
  *
  * Driver management:
  *   Driver side:
@@ -107,14 +112,27 @@ URT_DECL_BEGIN
  * update			update the skin by detaching from removed drivers and attaching to new/revived ones.
  *				Similar to load, newly created readers are created similarly and automatically copy data from drivers.
  *				If a driver is already attached but uses a different task_attr, its reader is recreated.
+ * set_reader_group		set a reader group for the readers created by load and update.  If set, and if the task_attr
+ *				given to load or update is periodic with the same period as the group's, the readers are
+ *				created as pull readers that join this group instead of each having its own task.  This
+ *				way, the whole skin is read by a single task, and the group's read callback is called
+ *				when all drivers are read.  With NULL, the readers are created normally.
+ * set_soft_reader_pool		create a pool of worker tasks for soft readers.  Soft readers of periodic writers attached
+ *				from then on (by service_attach, driver_attach, load or update) have no task of their own.
+ *				Instead, they are read by the first free worker whenever their writer publishes a new frame.
+ *				task_attr gives the priority and stack size of the workers, and may be NULL.  With a
+ *				worker_count of 0, the pool is removed.  The pool cannot be replaced or removed while it
+ *				has readers (EBUSY).  It is only available in user space (otherwise ENOTSUP).
  *
  * Running:
- * pause			pause all writers and readers of the skin, from both services and drivers.
- * resume			resume all writers and readers of the skin, from both services and drivers.
+ * pause			pause all writers, readers and reader groups of the skin, from both services and drivers.
+ * resume			resume all writers, readers and reader groups of the skin, from both services and drivers.
  * request			request all sporadic users of skin for one read.
  *
  * Info:
  * *_count			return number of objects and entities.
+ * get_responses		copy the responses of all sensors into an array of at most count responses, in the same
+ *				order as skin_for_each_sensor.  The return value is the number of responses copied.
  *
  * Access:
  * for_each_*			iterators over writers, readers, drivers, users, sensors, modules and patches.
@@ -147,6 +165,11 @@ struct skin_reader *(skin_service_attach)(struct skin *skin, const struct skin_r
 		const urt_task_attr *task_attr, const struct skin_reader_callbacks *callbacks, int *error, ...);
 void skin_service_detach(struct skin_reader *reader);
 
+#define skin_reader_group_add(...) skin_reader_group_add(__VA_ARGS__, NULL)
+struct skin_reader_group *(skin_reader_group_add)(struct skin *skin, const urt_task_attr *task_attr,
+		const struct skin_reader_group_callbacks *callbacks, int *error, ...);
+void skin_reader_group_remove(struct skin_reader_group *group);
+
 /* drivers */
 
 #define skin_driver_add(...) skin_driver_add(__VA_ARGS__, NULL)
@@ -166,6 +189,10 @@ void skin_driver_detach(struct skin_user *user);
 int skin_load(struct skin *skin, const urt_task_attr *task_attr);
 void skin_unload(struct skin *skin);
 int skin_update(struct skin *skin, const urt_task_attr *task_attr);
+void skin_set_sensor_data_size(struct skin *skin, size_t size);
+void skin_set_contiguous_responses(struct skin *skin, bool contiguous);
+void skin_set_reader_group(struct skin *skin, struct skin_reader_group *group);
+int skin_set_soft_reader_pool(struct skin *skin, unsigned int worker_count, const urt_task_attr *task_attr);
 
 void skin_pause(struct skin *skin);
 void skin_resume(struct skin *skin);
@@ -179,10 +206,12 @@ size_t skin_writer_count(struct skin *skin);
 size_t skin_reader_count(struct skin *skin);
 size_t skin_driver_count(struct skin *skin);
 size_t skin_user_count(struct skin *skin);
+size_t skin_reader_group_count(struct skin *skin);
 skin_sensor_size skin_sensor_count(struct skin *skin);
 skin_module_size skin_module_count(struct skin *skin);
 skin_patch_size skin_patch_count(struct skin *skin);
 skin_sensor_type_size skin_sensor_type_count(struct skin *skin);
+skin_sensor_size skin_get_responses(struct skin *skin, skin_sensor_response *responses, skin_sensor_size count);
 
 /* object access */
 
@@ -226,6 +255,12 @@ int (skin_for_each_sensor_of_type)(struct skin *skin, skin_sensor_type_id type,
 #define skin_set_module_clean_hook(...) skin_set_module_clean_hook(__VA_ARGS__, NULL)
 #define skin_set_patch_init_hook(...) skin_set_patch_init_hook(__VA_ARGS__, NULL)
 #define skin_set_patch_clean_hook(...) skin_set_patch_clean_hook(__VA_ARGS__, NULL)
+#define skin_set_sensor_batch_init_hook(...) skin_set_sensor_batch_init_hook(__VA_ARGS__, NULL)
+#define skin_set_sensor_batch_clean_hook(...) skin_set_sensor_batch_clean_hook(__VA_ARGS__, NULL)
+#define skin_set_module_batch_init_hook(...) skin_set_module_batch_init_hook(__VA_ARGS__, NULL)
+#define skin_set_module_batch_clean_hook(...) skin_set_module_batch_clean_hook(__VA_ARGS__, NULL)
+#define skin_set_patch_batch_init_hook(...) skin_set_patch_batch_init_hook(__VA_ARGS__, NULL)
+#define skin_set_patch_batch_clean_hook(...) skin_set_patch_batch_clean_hook(__VA_ARGS__, NULL)
 void (skin_set_writer_init_hook)(struct skin *skin, skin_hook_writer hook, void *user_data, ...);
 void (skin_set_writer_clean_hook)(struct skin *skin, skin_hook_writer hook, void *user_data, ...);
 void (skin_set_reader_init_hook)(struct skin *skin, skin_hook_reader hook, void *user_data, ...);
@@ -240,9 +275,16 @@ void (skin_set_module_init_hook)(struct skin *skin, skin_hook_module hook, void
 void (skin_set_module_clean_hook)(struct skin *skin, skin_hook_module hook, void *user_data, ...);
 void (skin_set_patch_init_hook)(struct skin *skin, skin_hook_patch hook, void *user_data, ...);
 void (skin_set_patch_clean_hook)(struct skin *skin, skin_hook_patch hook, void *user_data, ...);
+void (skin_set_sensor_batch_init_hook)(struct skin *skin, skin_hook_sensor_batch hook, void *user_data, ...);
+void (skin_set_sensor_batch_clean_hook)(struct skin *skin, skin_hook_sensor_batch hook, void *user_data, ...);
+void (skin_set_module_batch_init_hook)(struct skin *skin, skin_hook_module_batch hook, void *user_data, ...);
+void (skin_set_module_batch_clean_hook)(struct skin *skin, skin_hook_module_batch hook, void *user_data, ...);
+void (skin_set_patch_batch_init_hook)(struct skin *skin, skin_hook_patch_batch hook, void *user_data, ...);
+void (skin_set_patch_batch_clean_hook)(struct skin *skin, skin_hook_patch_batch hook, void *user_data, ...);
 
 /* internal functions for tools */
 void skin_internal_print_info(struct skin *skin);
+void skin_internal_watch_info(struct skin *skin, unsigned int interval, volatile sig_atomic_t *stop);
 
 URT_DECL_END
 
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SKIN_HISTOGRAM_H
+#define SKIN_HISTOGRAM_H
+
+#include "skin_types.h"
+
+URT_DECL_BEGIN
+
+/*
+ * a log-linear histogram of time durations.  Values below 2^SKIN_HISTOGRAM_SUB_BUCKET_BITS have a bucket of their
+ * own.  Above that, every power of two range is divided in 2^SKIN_HISTOGRAM_SUB_BUCKET_BITS equally sized buckets,
+ * which bounds the relative error of each recorded value to 1/2^SKIN_HISTOGRAM_SUB_BUCKET_BITS (12.5%).  Values of
+ * 2^SKIN_HISTOGRAM_MAX_BITS nanoseconds (about 68 seconds) and above are all recorded in the last bucket.
+ */
+#define SKIN_HISTOGRAM_SUB_BUCKET_BITS 3
+#define SKIN_HISTOGRAM_MAX_BITS 36
+#define SKIN_HISTOGRAM_BUCKET_COUNT ((SKIN_HISTOGRAM_MAX_BITS - SKIN_HISTOGRAM_SUB_BUCKET_BITS + 1) \
+		<< SKIN_HISTOGRAM_SUB_BUCKET_BITS)
+
+/* histogram types of readers */
+#define SKIN_READER_HISTOGRAM_READ_TIME 0
+#define SKIN_READER_HISTOGRAM_LATENCY 1
+
+struct skin_histogram
+{
+	uint64_t total;				/* number of recorded values */
+	uint64_t counts[SKIN_HISTOGRAM_BUCKET_COUNT];
+						/* number of recorded values in each bucket */
+};
+
+/*
+ * record		add a value to the histogram
+ * percentile		get the value below which the given percentile of the recorded values fall.  The
+ *			percentile is given in thousandths of a percent, e.g. 99900 for 99.9%, and the upper
+ *			bound of the bucket it falls in is returned.  If the histogram is empty, 0 is returned.
+ * bucket_low		the smallest value recorded in a bucket
+ * bucket_high		the largest value recorded in a bucket
+ */
+void skin_histogram_record(struct skin_histogram *hist, urt_time value);
+urt_time skin_histogram_percentile(const struct skin_histogram *hist, uint32_t percentile);
+urt_time skin_histogram_bucket_low(unsigned int bucket);
+urt_time skin_histogram_bucket_high(unsigned int bucket);
+
+URT_DECL_END
+
+#endif
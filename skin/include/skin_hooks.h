@@ -25,11 +25,14 @@
 #ifndef SKIN_HOOKS_H
 #define SKIN_HOOKS_H
 
+#include "skin_types.h"
+
 /*
  * this file contains callback definitions for skin_set_*_*_hook functions.
  *
  * Each of these callbacks gets a pointer to an object, as well as
- * a user provided data.
+ * a user provided data.  The batch hooks get all the sensors, modules
+ * or patches of a user at once, as an array and its size.
  */
 
 struct skin_writer;
@@ -50,4 +53,8 @@ typedef void (*skin_hook_sensor)(struct skin_sensor *s, void *data);
 typedef void (*skin_hook_module)(struct skin_module *m, void *data);
 typedef void (*skin_hook_patch)(struct skin_patch *p, void *data);
 
+typedef void (*skin_hook_sensor_batch)(struct skin_sensor *s, skin_sensor_size count, void *data);
+typedef void (*skin_hook_module_batch)(struct skin_module *m, skin_module_size count, void *data);
+typedef void (*skin_hook_patch_batch)(struct skin_patch *p, skin_patch_size count, void *data);
+
 #endif
@@ -36,6 +36,7 @@ struct skin_patch;
 /*
  * sensor_count			number of sensors
  * get_patch			get patch this module belongs to
+ * get_response_span		get the responses of all sensors of the module as a span
  * for_each_sensor		iterators over sensors.  The return value is 0 if all were
  *				iterated and non-zero if the callback had terminated the iteration prematurely,
  *				or if there was an error.
@@ -53,6 +54,7 @@ struct skin_module
 
 URT_INLINE skin_sensor_size skin_module_sensor_count(struct skin_module *module) { return module->sensor_count; }
 struct skin_patch *skin_module_get_patch(struct skin_module *module);
+struct skin_response_span skin_module_get_response_span(struct skin_module *module);
 
 #define skin_module_for_each_sensor(...) skin_module_for_each_sensor(__VA_ARGS__, NULL)
 int (skin_module_for_each_sensor)(struct skin_module *module, skin_callback_sensor callback, void *user_data, ...);
@@ -35,6 +35,8 @@ struct skin_user;
 
 /*
  * *_count			number of sensors and modules
+ * get_response_span		get the responses of all sensors of the patch as a span.  The responses of the sensors
+ *				of a patch are contiguous in its user's responses array
  * for_each_*			iterators over sensors and modules.  The return value is 0 if all were
  *				iterated and non-zero if the callback had terminated the iteration prematurely,
  *				or if there was an error.
@@ -51,6 +53,7 @@ struct skin_patch
 
 skin_sensor_size skin_patch_sensor_count(struct skin_patch *patch);
 URT_INLINE skin_module_size skin_patch_module_count(struct skin_patch *patch) { return patch->module_count; }
+struct skin_response_span skin_patch_get_response_span(struct skin_patch *patch);
 
 #define skin_patch_for_each_sensor(...) skin_patch_for_each_sensor(__VA_ARGS__, NULL)
 #define skin_patch_for_each_module(...) skin_patch_for_each_module(__VA_ARGS__, NULL)
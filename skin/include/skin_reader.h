@@ -26,10 +26,12 @@
 #define SKIN_READER_H
 
 #include "skin_types.h"
+#include "skin_histogram.h"
 
 URT_DECL_BEGIN
 
 struct skin_reader;
+struct skin_reader_group;
 struct skin_user;
 
 struct skin_reader_attr
@@ -39,6 +41,24 @@ struct skin_reader_attr
 						 * The reader tries to attach to the memory and locks created
 						 * by the writer with this prefix.
 						 */
+	bool lossless;				/*
+						 * if true, the reader is given every frame written since its
+						 * last read from the writer's history ring, rather than only
+						 * the latest one.  The writer must have history.
+						 */
+	bool pull;				/*
+						 * if true, no task is created for the reader.  Instead, data
+						 * is read in the caller's thread with skin_reader_read_latest,
+						 * optionally after waiting with skin_reader_wait_new.  The
+						 * task attributes are then ignored.
+						 */
+	bool phase_locked;			/*
+						 * if true, the period of the reader is aligned to the
+						 * instants the writer publishes its frames, so that the
+						 * reader wakes up shortly after each new frame rather than
+						 * at an arbitrary phase.  Only effective for periodic readers
+						 * of periodic writers; otherwise it is ignored.
+						 */
 };
 
 struct skin_reader_callbacks
@@ -63,6 +83,10 @@ struct skin_reader_statistics
 	urt_time best_read_time;		/* execution time */
 	urt_time accumulated_read_time;		/* of the readers */
 	uint64_t read_count;			/* number of frame reads since spawn */
+	uint64_t frames_dropped;		/* number of frames overwritten in history before read (if lossless) */
+	uint64_t frames_missed;			/* number of frames written but never read (if not lossless) */
+	uint64_t stale_wakeups;			/* number of times woken up with no new data */
+	uint64_t lock_retries;			/* number of times synchronization with the writer was retried */
 };
 
 /*
@@ -86,6 +110,40 @@ struct skin_reader_statistics
  * get_attr		get the attributes with which the reader is initialized.  The name attribute
  *			is valid only while the reader is alive.
  * get_statistics	return reader statistics
+ * get_histogram	return a histogram of the reader; either of execution times (SKIN_READER_HISTOGRAM_READ_TIME)
+ *			or of the age of data when read (SKIN_READER_HISTOGRAM_LATENCY)
+ * get_frame_number	the number of the frame being read.  Writers number their frames from 0 since their
+ *			creation.  This function is meant to be called in the read callback.  If the reader
+ *			is lossless and is given multiple frames, they are consecutive and this is the number
+ *			of the first one.
+ *
+ * Pull readers (see skin_reader_attr) have no task, and are instead read from with the following functions.  These
+ * functions must not be called concurrently on the same reader.
+ *
+ * read_latest		call the read callback in the caller's thread with the latest frame of the writer (or all frames
+ *			since the last read, if lossless), if it is newer than what was last read.  If the writer is sporadic,
+ *			a write is requested first.  The timeout bounds the time spent synchronizing with the writer.
+ *			Returns EAGAIN if there is no new data (or if paused), ETIMEDOUT on timeout and ENOENT if
+ *			the writer is no longer active.
+ * wait_new		wait until the writer has data newer than what was last read, or until timeout.  Returns
+ *			ETIMEDOUT on timeout and ENOENT if the writer is no longer active.  With a sporadic writer, there
+ *			is always new data to be requested, so this function returns immediately.
+ *
+ * Any reader can also be notified of new frames through a file descriptor, so that it can be waited on with
+ * poll, epoll etc along with other descriptors, for example in an event loop.  This is only available in user space.
+ *
+ * get_notify_fd	get a descriptor that becomes readable whenever the writer publishes a new frame.  The descriptor
+ *			is created on first call and is closed when the reader is detached.  On error, -1 is returned.
+ * clear_notification	consume the pending notifications, so the descriptor is no longer readable until the next frame.
+ *
+ * Pull readers can also be read from by the task of a reader group (see skin_reader_group.h), instead of the caller.
+ * While in a group, the reader must not be read from with read_latest by anyone else.
+ *
+ * join_group		join a reader group.  Returns EINVAL if the reader is not a pull reader and EALREADY if it is
+ *			already in a group.
+ * leave_group		leave the reader group the reader is in, if any.  The reader is not read by the group after
+ *			this function returns.  A reader leaves its group automatically when detached.
+ * get_group		the group the reader is in, or NULL if none.
  */
 int skin_reader_pause(struct skin_reader *reader);
 int skin_reader_resume(struct skin_reader *reader);
@@ -100,6 +158,19 @@ int (skin_reader_await_response)(struct skin_reader *reader, volatile sig_atomic
 struct skin_user *skin_reader_get_user(struct skin_reader *reader);
 int skin_reader_get_attr(struct skin_reader *reader, struct skin_reader_attr *attr);
 int skin_reader_get_statistics(struct skin_reader *reader, struct skin_reader_statistics *stats);
+int skin_reader_get_histogram(struct skin_reader *reader, int type, struct skin_histogram *hist);
+uint64_t skin_reader_get_frame_number(struct skin_reader *reader);
+
+int skin_reader_read_latest(struct skin_reader *reader, urt_time timeout);
+int skin_reader_wait_new(struct skin_reader *reader, urt_time timeout);
+
+#define skin_reader_get_notify_fd(...) skin_reader_get_notify_fd(__VA_ARGS__, NULL)
+int (skin_reader_get_notify_fd)(struct skin_reader *reader, int *error, ...);
+int skin_reader_clear_notification(struct skin_reader *reader);
+
+int skin_reader_join_group(struct skin_reader *reader, struct skin_reader_group *group);
+int skin_reader_leave_group(struct skin_reader *reader);
+struct skin_reader_group *skin_reader_get_group(struct skin_reader *reader);
 
 /* internal */
 void skin_reader_acquisition_task(urt_task *task, void *data);
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SKIN_READER_GROUP_H
+#define SKIN_READER_GROUP_H
+
+#include "skin_types.h"
+
+URT_DECL_BEGIN
+
+struct skin_reader_group;
+
+struct skin_reader_group_callbacks
+{
+	void (*read)(struct skin_reader_group *group, void *user_data);
+						/*
+						 * a function that will be called by the group thread
+						 * once every period, after all its readers are read.
+						 */
+	void (*init)(struct skin_reader_group *group, void *user_data);
+						/* a function to be called after a group is created */
+	void (*clean)(struct skin_reader_group *group, void *user_data);
+						/* a function to be called before a group is removed */
+	void *user_data;
+};
+
+/*
+ * reader groups are created and removed with skin_reader_group_add/remove.  A group has a single periodic task
+ * that, in each period, reads all the readers of the group one after the other, and then calls the group's read
+ * callback.  Many readers with the same period and priority could thus be serviced with one thread and one wakeup,
+ * and the read callback of the group serves as a point where all of them are known to have been read.
+ *
+ * Readers join and leave a group with skin_reader_join_group/leave_group.  Only pull readers (see skin_reader_attr)
+ * can join a group, and each reader can be in at most one group.  Each reader is given until the start of the next
+ * period to be read, so the readers at the end of the group could miss their read if the ones before them take too
+ * long.
+ *
+ * pause		pause a group.  The readers of the group are not read while the group is paused.
+ * resume		resume a group.  A group that has been just created is initially in a paused state and should
+ *			be resumed to actually start working.
+ * is_paused		whether the group is paused or not.
+ * reader_count		the number of readers in the group.
+ */
+int skin_reader_group_pause(struct skin_reader_group *group);
+int skin_reader_group_resume(struct skin_reader_group *group);
+bool skin_reader_group_is_paused(struct skin_reader_group *group);
+size_t skin_reader_group_reader_count(struct skin_reader_group *group);
+
+URT_DECL_END
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SKIN_RESPONSES_H
+#define SKIN_RESPONSES_H
+
+#include "skin_types.h"
+
+URT_DECL_BEGIN
+
+/*
+ * bulk operations on arrays of sensor responses, such as those returned by skin_user_get_responses,
+ * skin_*_get_response_span or skin_get_responses.  These functions are available in user space only.
+ *
+ * Each operation has a scalar implementation as well as vectorized ones (SSE2 and AVX2 on x86, NEON on ARM).
+ * The best implementation supported by the processor is selected at runtime, on first use.  All implementations
+ * produce exactly the same results.
+ *
+ * to_u8			convert responses to 8-bit values, as response * 255 / SKIN_SENSOR_RESPONSE_MAX
+ * to_float			convert responses to floating point values in [0, 1], as
+ *				response * (1.0f / SKIN_SENSOR_RESPONSE_MAX)
+ * subtract_baseline		subtract a baseline from responses, saturating at 0.  dst may be the same as src
+ * min_max			update per-sensor minimum and maximum with new responses
+ * threshold			set mask to 1 where response is at least threshold and 0 otherwise.  The return value
+ *				is the number of responses at or above the threshold
+ *
+ * select_simd			select a specific implementation, for example for benchmarking.  Returns ENOTSUP
+ *				if the processor doesn't support it, or EINVAL if invalid.  This function should not
+ *				be called while the above functions are in use by other threads
+ * simd_name			get the name of the implementation in use
+ */
+enum skin_responses_simd
+{
+	SKIN_RESPONSES_SIMD_BEST = 0,
+	SKIN_RESPONSES_SIMD_SCALAR,
+	SKIN_RESPONSES_SIMD_SSE2,
+	SKIN_RESPONSES_SIMD_AVX2,
+	SKIN_RESPONSES_SIMD_NEON,
+};
+
+void skin_responses_to_u8(uint8_t *dst, const skin_sensor_response *src, size_t count);
+void skin_responses_to_float(float *dst, const skin_sensor_response *src, size_t count);
+void skin_responses_subtract_baseline(skin_sensor_response *dst, const skin_sensor_response *src,
+		const skin_sensor_response *baseline, size_t count);
+void skin_responses_min_max(skin_sensor_response *min, skin_sensor_response *max,
+		const skin_sensor_response *src, size_t count);
+size_t skin_responses_threshold(uint8_t *mask, const skin_sensor_response *src,
+		skin_sensor_response threshold, size_t count);
+
+int skin_responses_select_simd(enum skin_responses_simd simd);
+const char *skin_responses_simd_name(void);
+
+URT_DECL_END
+
+#endif
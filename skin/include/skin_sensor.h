@@ -41,15 +41,12 @@ struct skin_sensor
 {
 	skin_sensor_id		id;		/* index in its user's sensor array */
 	skin_sensor_unique_id	uid;		/* unique hardware-derived id of the sensor (unique in its type) */
-	skin_sensor_response	response;	/* sensor response */
+	skin_sensor_response	response;	/* sensor response (not updated if the user has contiguous_responses) */
 	skin_module_id		module;		/* index in its user's module array */
 	skin_sensor_type_id	type;		/* type of sensor */
 	struct skin_user	*user;		/* user it belongs to */
 
 	void			*user_data;	/* arbitrary user data */
-
-	/* internal */
-	skin_sensor_id		next_of_type;	/* next sensor index that has the same type as this sensor */
 };
 
 URT_INLINE skin_sensor_response skin_sensor_get_response(struct skin_sensor *sensor) { return sensor->response; }
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SKIN_SNAPSHOT_H
+#define SKIN_SNAPSHOT_H
+
+#include "skin_types.h"
+#include "skin_writer.h"
+#include "skin_reader.h"
+#include "skin_driver.h"
+#include "skin_histogram.h"
+
+URT_DECL_BEGIN
+
+struct skin;
+
+/*
+ * a snapshot of the skin kernel, i.e. of all writers, drivers and readers of every process, together with their
+ * statistics.  The objects are kept in flat arrays and refer to each other by their index in the skin kernel, which
+ * makes them easy to export.  Only readers with shared statistics are included (see configure's
+ * --with-max-reader-stats).
+ */
+struct skin_writer_snapshot
+{
+	uint16_t index;				/* index of the writer in the skin kernel */
+	char name[URT_NAME_LEN + 1];		/* name of the writer */
+	bool is_driver;				/* whether this is the writer of a driver */
+	uint16_t driver_index;			/* if writer of a driver, the driver's index */
+	bool active;				/* whether the writer is active (not removed) */
+	bool paused;				/* whether the writer is paused */
+	bool bad;				/* whether the writer callback has declared failure */
+	size_t buffer_size;			/* attributes of the writer */
+	uint8_t buffer_count;
+	bool lock_free;
+	uint32_t history;
+	urt_time period;			/* period of the writer, or 0 if sporadic */
+	unsigned int readers_attached;		/* number of readers attached */
+	uint64_t frame_count;			/* number of frames written */
+	struct skin_writer_statistics stats;
+	struct skin_histogram write_times;	/* histogram of execution times */
+};
+
+struct skin_reader_snapshot
+{
+	uint16_t writer_index;			/* index of the writer this reader is attached to */
+	uint16_t slot;				/* index of the reader among the readers of the writer */
+	struct skin_reader_statistics stats;
+	struct skin_histogram read_times;	/* histogram of execution times */
+};
+
+struct skin_sensor_type_snapshot
+{
+	uint16_t driver_index;			/* index of the driver providing the sensors */
+	skin_sensor_type_id type;		/* sensor type */
+	skin_sensor_size sensor_count;		/* number of sensors of this type provided by the driver */
+};
+
+struct skin_driver_snapshot
+{
+	uint16_t index;				/* index of the driver in the skin kernel */
+	uint16_t writer_index;			/* index of the driver's writer */
+	bool active;				/* whether the driver is active (not removed) */
+	unsigned int users_attached;		/* number of users attached */
+	struct skin_driver_attr attr;		/* patch, module and sensor counts */
+	skin_sensor_type_size sensor_type_count;
+						/* number of sensor types provided by the driver */
+	size_t sensor_types_begin;		/* index of the driver's first sensor type in the snapshot's sensor_types */
+};
+
+struct skin_kernel_snapshot
+{
+	urt_time time;				/* the time the snapshot was taken */
+	size_t writer_count;
+	size_t reader_count;
+	size_t driver_count;
+	size_t sensor_type_count;
+	struct skin_writer_snapshot *writers;
+	struct skin_reader_snapshot *readers;
+	struct skin_driver_snapshot *drivers;
+	struct skin_sensor_type_snapshot *sensor_types;
+
+	/* internal */
+	size_t writers_mem_size;
+	size_t readers_mem_size;
+	size_t drivers_mem_size;
+	size_t sensor_types_mem_size;
+};
+
+/*
+ * get_kernel_snapshot	take a snapshot of the skin kernel.  The snapshot must be zero-initialized the first time,
+ *			after which it can be reused for subsequent snapshots without further memory allocation.
+ *			It doesn't interfere with the real-time tasks, so it can be taken at high rates.
+ * kernel_snapshot_free	free the memory allocated for a snapshot
+ */
+int skin_get_kernel_snapshot(struct skin *skin, struct skin_kernel_snapshot *snapshot);
+void skin_kernel_snapshot_free(struct skin_kernel_snapshot *snapshot);
+
+URT_DECL_END
+
+#endif
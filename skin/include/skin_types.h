@@ -55,4 +55,15 @@ typedef uint16_t skin_sensor_response;
 
 #define SKIN_SENSOR_RESPONSE_MAX ((skin_sensor_response)0xffff)
 
+/*
+ * a view of `count` sensor responses, starting at `responses` and `stride` responses apart.
+ * An empty span has a `count` of 0.
+ */
+struct skin_response_span
+{
+	const skin_sensor_response *responses;
+	skin_sensor_size count;
+	skin_sensor_size stride;
+};
+
 #endif
@@ -46,6 +46,19 @@ struct skin_user_attr
 						 * This is only used if the reader attribute is "".  Otherwise that
 						 * attribute directly identifies a single driver.
 						 */
+	size_t sensor_data_size;		/*
+						 * size of extra per-sensor data.  If non-zero, this much zeroed memory
+						 * is reserved for each sensor in the same allocation as the rest of the
+						 * user's data structures, and `user_data` of each sensor points to it
+						 * before the init hooks are called.  This saves allocating per-sensor
+						 * data from the sensor init hook.
+						 */
+	bool contiguous_responses;		/*
+						 * if true, the default peek callback only keeps the responses in the
+						 * user's contiguous response array (see skin_user_get_responses), and
+						 * the response field of the sensors is not updated.  This saves a
+						 * second, scattered copy of the responses on every frame.
+						 */
 };
 
 struct skin_user_callbacks
@@ -56,8 +69,8 @@ struct skin_user_callbacks
 						 * It should read in the sensor responses.
 						 *
 						 * If NULL, the default function will be used, which simply
-						 * copies sensor responses to their respective skin_sensor
-						 * structure.
+						 * copies sensor responses to the user's response array (see
+						 * skin_user_get_responses).
 						 */
 	void (*init)(struct skin_user *user, void *user_data);
 						/* a function to be called after a user is created */
@@ -82,8 +95,18 @@ struct skin_user_callbacks
  * is_active			whether driver this user is attached to is still active
  *
  * get_reader			get reader associated with user
+ * get_responses		get the responses of all sensors of the user as a contiguous array, indexed by
+ *				sensor id.  This array is updated by the default peek callback only.
+ * get_response_span		get the responses of all sensors of the user as a span.
+ * get_response_span_of_type	get the responses of all sensors of a given type as a span, in the order of sensor ids.
+ *				An empty span is returned if the user has no sensor of that type.
+ * get_sensors_of_type		get the ids of all sensors of a given type, in increasing order, and their count.
+ *				NULL is returned if the user has no sensor of that type.
  *
  * *_count			number of sensors, modules and patches
+ * sensor_offset		index of the first sensor of the user among all sensors of the skin, as visited by
+ *				skin_for_each_sensor and copied by skin_get_responses.  This changes when a user
+ *				before this one is detached
  * for_each_*			iterators over sensors, modules and patches.  The return value is 0 if all were
  *				iterated and non-zero if the callback had terminated the iteration prematurely,
  *				or if there was an error.
@@ -96,7 +119,14 @@ URT_INLINE int skin_user_resume(struct skin_user *user) { return skin_reader_res
 URT_INLINE bool skin_user_is_paused(struct skin_user *user) { return skin_reader_is_paused(skin_user_get_reader(user)); }
 bool skin_user_is_active(struct skin_user *user);
 
+const skin_sensor_response *skin_user_get_responses(struct skin_user *user);
+struct skin_response_span skin_user_get_response_span(struct skin_user *user);
+struct skin_response_span skin_user_get_response_span_of_type(struct skin_user *user, skin_sensor_type_id type);
+const skin_sensor_id *skin_user_get_sensors_of_type(struct skin_user *user, skin_sensor_type_id type,
+		skin_sensor_size *count);
+
 skin_sensor_size skin_user_sensor_count(struct skin_user *user);
+skin_sensor_size skin_user_sensor_offset(struct skin_user *user);
 skin_module_size skin_user_module_count(struct skin_user *user);
 skin_patch_size skin_user_patch_count(struct skin_user *user);
 skin_sensor_type_size skin_user_sensor_type_count(struct skin_user *user);
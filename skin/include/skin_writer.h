@@ -26,6 +26,7 @@
 #define SKIN_WRITER_H
 
 #include "skin_types.h"
+#include "skin_histogram.h"
 
 URT_DECL_BEGIN
 
@@ -40,6 +41,15 @@ struct skin_writer_attr
 						 * name prefix of writer (max URT_NAME_LEN - 3 characters).
 						 * The names used by the writer will have this as prefix.
 						 */
+	bool lock_free;				/*
+						 * if true, buffers are published to readers with sequence
+						 * counters instead of locks.  Readers never block the writer,
+						 * but take a private copy of the data instead.
+						 */
+	uint32_t history;			/*
+						 * number of past frames to keep in a history ring (0 for none).
+						 * Lossless readers are only possible if there is history.
+						 */
 };
 
 struct skin_writer_callbacks
@@ -64,6 +74,8 @@ struct skin_writer_statistics
 	urt_time accumulated_write_time;	/* of the writers */
 	uint64_t write_count;			/* number of frame writes since spawn */
 	uint64_t swap_skips;			/* number of times swap was skipped */
+	uint64_t swap_count;			/* number of successful swaps */
+	urt_time swap_budget;			/* time given to the last swap */
 };
 
 /*
@@ -86,6 +98,7 @@ struct skin_writer_statistics
  * get_attr		get the attributes with which the writer is initialized.  The name attribute
  *			is valid only while the writer is alive.
  * get_statistics	return writer statistics
+ * get_histogram	return the histogram of writer execution times
  *
  * copy_last_buffer	copy data of last buffer in current buffer
  */
@@ -102,6 +115,7 @@ int (skin_writer_await_response)(struct skin_writer *writer, volatile sig_atomic
 struct skin_driver *skin_writer_get_driver(struct skin_writer *writer);
 int skin_writer_get_attr(struct skin_writer *writer, struct skin_writer_attr *attr);
 int skin_writer_get_statistics(struct skin_writer *writer, struct skin_writer_statistics *stats);
+int skin_writer_get_histogram(struct skin_writer *writer, struct skin_histogram *hist);
 
 void skin_writer_copy_last_buffer(struct skin_writer *writer);
 
@@ -36,6 +36,7 @@
 #include "internal.h"
 #include "reader_internal.h"
 #include "names.h"
+#include "reader_pool.h"
 
 static void _init_kernel(struct skin_kernel *sk)
 {
@@ -44,8 +45,10 @@ static void _init_kernel(struct skin_kernel *sk)
 	sk->initialization_failed = false;
 
 	*sk = (struct skin_kernel){
-		.max_driver_count = SKIN_CONFIG_MAX_DRIVERS,
-		.max_writer_count = SKIN_CONFIG_MAX_DRIVERS + SKIN_CONFIG_MAX_SERVICES,
+		.max_driver_count = SKIN_KERNEL_DRIVER_BLOCK_SIZE,
+		.max_writer_count = SKIN_KERNEL_WRITER_BLOCK_SIZE,
+		.driver_block_count = 1,
+		.writer_block_count = 1,
 		.sizeof_skin_kernel = sizeof(struct skin_kernel),
 		.sizeof_sensor = sizeof(struct skin_sensor),
 		.sizeof_module = sizeof(struct skin_module),
@@ -55,6 +58,7 @@ static void _init_kernel(struct skin_kernel *sk)
 	};
 
 	memset(sk->writers, 0, sizeof(struct skin_writer_info[sk->max_writer_count]));
+	skin_internal_init_kernel_indices(sk);
 }
 
 static int _sanity_check_kernel(struct skin_kernel *sk)
@@ -133,26 +137,17 @@ static int _get_kernel_locks(struct skin_kernel_locks *kernel_locks, char *name,
 static int _get_memories(struct skin *skin)
 {
 	int error = 0;
-	unsigned int i;
-
 	skin->writers_mem_size = SKIN_CONFIG_MAX_DRIVERS + SKIN_CONFIG_MAX_SERVICES;
 	skin->readers_mem_size = SKIN_CONFIG_MAX_DRIVERS + SKIN_CONFIG_MAX_SERVICES;
 	skin->drivers_mem_size = SKIN_CONFIG_MAX_DRIVERS;
 	skin->users_mem_size = SKIN_CONFIG_MAX_SERVICES;
+	skin->reader_groups_mem_size = 4;
 
 	skin->writers = urt_mem_new(skin->writers_mem_size * sizeof *skin->writers, &error);
 	skin->readers = urt_mem_new(skin->readers_mem_size * sizeof *skin->readers, &error);
 	skin->drivers = urt_mem_new(skin->drivers_mem_size * sizeof *skin->drivers, &error);
 	skin->users = urt_mem_new(skin->users_mem_size * sizeof *skin->users, &error);
-
-	for (i = 0; i < skin->writers_mem_size; ++i)
-		skin->writers[i] = NULL;
-	for (i = 0; i < skin->readers_mem_size; ++i)
-		skin->readers[i] = NULL;
-	for (i = 0; i < skin->drivers_mem_size; ++i)
-		skin->drivers[i] = NULL;
-	for (i = 0; i < skin->users_mem_size; ++i)
-		skin->users[i] = NULL;
+	skin->reader_groups = urt_mem_new(skin->reader_groups_mem_size * sizeof *skin->reader_groups, &error);
 
 	return error;
 }
@@ -163,6 +158,9 @@ static void _free_memories(struct skin *skin)
 	urt_mem_delete(skin->readers);
 	urt_mem_delete(skin->drivers);
 	urt_mem_delete(skin->users);
+	urt_mem_delete(skin->reader_groups);
+	urt_mem_delete(skin->sensor_types);
+	urt_mem_delete(skin->driver_users);
 }
 
 static void _detach_from_kernel_locks(struct skin_kernel_locks *kernel_locks)
@@ -183,9 +181,10 @@ static void _detach_from_kernel_locks(struct skin_kernel_locks *kernel_locks)
 #endif
 }
 
-static void _detach_from_kernel(struct skin_kernel *sk)
+static void _detach_from_kernel(struct skin *skin)
 {
-	urt_shmem_detach(sk);
+	skin_internal_detach_kernel_blocks(skin);
+	urt_shmem_detach(skin->kernel);
 }
 
 struct skin *(skin_init)(const char *prefix, int *error, ...)
@@ -216,7 +215,7 @@ struct skin *(skin_init)(const char *prefix, int *error, ...)
 	/* try creating a new environment, if failed, Skinware is already up, so attach to it */
 	skin_internal_name_set_suffix(suffix, "MEM");
 	skin->kernel = urt_shmem_new(name, sizeof(struct skin_kernel)
-			+ sizeof(struct skin_writer_info[SKIN_CONFIG_MAX_DRIVERS + SKIN_CONFIG_MAX_SERVICES]));
+			+ sizeof(struct skin_writer_info[SKIN_KERNEL_WRITER_BLOCK_SIZE]));
 	if (skin->kernel == NULL)
 		skin->kernel = urt_shmem_attach(name, &err);
 	else
@@ -242,6 +241,11 @@ struct skin *(skin_init)(const char *prefix, int *error, ...)
 	if ((err = _get_kernel_locks(&skin->kernel_locks, name, suffix, is_new)))
 		goto exit_no_kernel_locks;
 
+	/* the additional blocks of skin kernel are named after the same prefix */
+	*suffix = '\0';
+	skin_internal_name_cpy_prefix(skin->kernel_prefix, name);
+	skin_internal_attach_kernel_blocks(skin);
+
 	if (is_new)
 		skin->kernel->initialized = true;
 
@@ -257,7 +261,7 @@ exit_no_kernel_locks:
 		skin->kernel->initialization_failed = true;
 	_detach_from_kernel_locks(&skin->kernel_locks);
 exit_sanity_failed:
-	_detach_from_kernel(skin->kernel);
+	_detach_from_kernel(skin);
 exit_no_attach:
 	urt_mem_delete(skin);
 exit_no_mem:
@@ -275,10 +279,11 @@ void skin_free(struct skin *skin)
 		return;
 
 	skin_unload(skin);
+	skin_internal_reader_pool_free(skin->soft_reader_pool);
 
 	_free_memories(skin);
 	_detach_from_kernel_locks(&skin->kernel_locks);
-	_detach_from_kernel(skin->kernel);
+	_detach_from_kernel(skin);
 
 #ifndef __KERNEL__
 # ifndef NDEBUG
@@ -291,31 +296,18 @@ void skin_free(struct skin *skin)
 }
 URT_EXPORT_SYMBOL(skin_free);
 
+/* the counts are kept up to date as objects are created and removed, and users are attached and detached */
 #define DEFINE_OBJECT_COUNT_FUNC(object)				\
-static int _##object##_count(struct skin_##object *obj, void *d)	\
-{									\
-	++*(size_t *)d;							\
-	return 0;							\
-}									\
 size_t skin_##object##_count(struct skin *skin)				\
 {									\
-	size_t res = 0;							\
-	skin_for_each_##object(skin, _##object##_count, &res);		\
-	return res;							\
+	return skin?skin->object##_count:0;				\
 }									\
 URT_EXPORT_SYMBOL(skin_##object##_count);
 
 #define DEFINE_ENTITY_COUNT_FUNC(entity)				\
-static int _##entity##_count(struct skin_user *user, void *d)		\
-{									\
-	*(skin_##entity##_size *)d += skin_user_##entity##_count(user);	\
-	return 0;							\
-}									\
 skin_##entity##_size skin_##entity##_count(struct skin *skin)		\
 {									\
-	skin_##entity##_size res = 0;					\
-	skin_for_each_user(skin, _##entity##_count, &res);		\
-	return res;							\
+	return skin?skin->entity##_count:0;				\
 }									\
 URT_EXPORT_SYMBOL(skin_##entity##_count);
 
@@ -323,21 +315,45 @@ DEFINE_OBJECT_COUNT_FUNC(writer)
 DEFINE_OBJECT_COUNT_FUNC(reader)
 DEFINE_OBJECT_COUNT_FUNC(driver)
 DEFINE_OBJECT_COUNT_FUNC(user)
+DEFINE_OBJECT_COUNT_FUNC(reader_group)
 
 DEFINE_ENTITY_COUNT_FUNC(sensor)
 DEFINE_ENTITY_COUNT_FUNC(module)
 DEFINE_ENTITY_COUNT_FUNC(patch)
+DEFINE_ENTITY_COUNT_FUNC(sensor_type)
 
-static int _sensor_type_count(struct skin_sensor_type *st, void *d)
+struct copy_responses_data
 {
-	++*(skin_sensor_type_size *)d;
-	return 0;
+	skin_sensor_response *responses;
+	skin_sensor_size remaining;
+};
+
+static int _copy_user_responses(struct skin_user *user, void *d)
+{
+	struct copy_responses_data *data = d;
+	struct skin_response_span span = skin_user_get_response_span(user);
+
+	if (span.count > data->remaining)
+		span.count = data->remaining;
+
+	memcpy(data->responses, span.responses, span.count * sizeof *span.responses);
+	data->responses += span.count;
+	data->remaining -= span.count;
+
+	return data->remaining == 0?SKIN_CALLBACK_STOP:SKIN_CALLBACK_CONTINUE;
 }
 
-skin_sensor_type_size skin_sensor_type_count(struct skin *skin)
+skin_sensor_size skin_get_responses(struct skin *skin, skin_sensor_response *responses, skin_sensor_size count)
 {
-	skin_sensor_type_size res = 0;
-	skin_for_each_sensor_type(skin, _sensor_type_count, &res);
-	return res;
+	struct copy_responses_data data = {
+		.responses = responses,
+		.remaining = count,
+	};
+
+	if (responses == NULL || count == 0)
+		return 0;
+
+	skin_for_each_user(skin, _copy_user_responses, &data);
+	return count - data.remaining;
 }
-URT_EXPORT_SYMBOL(skin_sensor_type_count);
+URT_EXPORT_SYMBOL(skin_get_responses);
@@ -41,10 +41,9 @@ static int _sanity_check_driver(struct skin_driver *driver)
 
 static struct skin_driver *_revive_driver(struct skin *skin, const struct skin_driver_attr *attr, const struct skin_writer *writer, int *error)
 {
-	struct skin_kernel *sk = skin->kernel;
 	struct skin_driver *driver = NULL;
-	struct skin_writer_info *writer_info = &sk->writers[writer->info_index];
-	struct skin_driver_info *d = &sk->drivers[writer_info->driver_index];
+	struct skin_writer_info *writer_info = skin_internal_writer_info(skin, writer->info_index);
+	struct skin_driver_info *d = skin_internal_driver_info(skin, writer_info->driver_index);
 	char name[URT_NAME_LEN + 1];
 
 	/* attach to the data structure memory of the reviving driver */
@@ -94,10 +93,9 @@ exit_fail:
 
 static struct skin_driver *_add_driver(struct skin *skin, const struct skin_driver_attr *attr, const struct skin_writer *writer, int *error)
 {
-	unsigned int i;
-	struct skin_kernel *sk = skin->kernel;
+	uint16_t i;
 	struct skin_driver *driver = NULL;
-	struct skin_writer_info *writer_info = &sk->writers[writer->info_index];
+	struct skin_writer_info *writer_info = skin_internal_writer_info(skin, writer->info_index);
 	char name[URT_NAME_LEN + 1];
 
 	/* allocate memory for the driver data structure */
@@ -110,39 +108,31 @@ static struct skin_driver *_add_driver(struct skin *skin, const struct skin_driv
 	ds->modules_offset = offsetof(skin_structure, modules);
 	ds->sensors_offset = offsetof(skin_structure, sensors);
 
-	for (i = 0; i < sk->max_driver_count; ++i)
-	{
-		struct skin_driver_info *d = &sk->drivers[i];
-
-		if (!d->active && d->users_attached == 0)
-		{
-			driver = urt_mem_new(sizeof *driver, error);
-			if (driver == NULL)
-				goto exit_fail;
-
-			*d = (struct skin_driver_info){
-				.attr = *attr,
-				.writer_index = writer->info_index,
-				.active = true,
-			};
-			*driver = (struct skin_driver){
-				.data_structure = ds,
-				.info_index = i,
-			};
-			writer_info->driver_index = i;
-
-			break;
-		}
-	}
-
+	driver = urt_mem_new(sizeof *driver, error);
 	if (driver == NULL)
-	{
-		*error = ENOSPC;
 		goto exit_fail;
-	}
+
+	i = skin_internal_driver_claim(skin);
+	if (i == SKIN_KERNEL_INVALID_INDEX)
+		goto exit_no_slot;
+
+	*skin_internal_driver_info(skin, i) = (struct skin_driver_info){
+		.attr = *attr,
+		.writer_index = writer->info_index,
+		.active = true,
+		.used = true,
+	};
+	*driver = (struct skin_driver){
+		.data_structure = ds,
+		.info_index = i,
+	};
+	writer_info->driver_index = i;
 
 exit_no_ds:
 	return driver;
+exit_no_slot:
+	*error = ENOSPC;
+	urt_mem_delete(driver);
 exit_fail:
 	urt_shmem_detach(ds);
 	return NULL;
@@ -183,6 +173,7 @@ static int _cache_sensor_types(struct skin_driver_info *d, struct skin_driver_de
 			if (d->sensor_types[i] == sensor->type)
 			{
 				already = true;
+				++d->sensor_type_sizes[i];
 				break;
 			}
 
@@ -192,6 +183,7 @@ static int _cache_sensor_types(struct skin_driver_info *d, struct skin_driver_de
 		if (d->sensor_type_count >= SKIN_CONFIG_MAX_SENSOR_TYPES)
 			return -1;
 
+		d->sensor_type_sizes[d->sensor_type_count] = 1;
 		d->sensor_types[d->sensor_type_count++] = sensor->type;
 	}
 	return 0;
@@ -202,7 +194,7 @@ SKIN_DEFINE_STORE_FUNCTION(driver);
 static int _driver_writer_callback(struct skin_writer *writer, void *mem, size_t size, void *user_data)
 {
 	struct skin_driver *driver = user_data;
-	struct skin_driver_info *info = &driver->skin->kernel->drivers[driver->info_index];
+	struct skin_driver_info *info = skin_internal_driver_info(driver->skin, driver->info_index);
 	return driver->callbacks.acquire(driver, mem, info->attr.sensor_count, driver->callbacks.user_data);
 }
 
@@ -259,7 +251,7 @@ struct skin_driver *(skin_driver_add)(struct skin *skin, const struct skin_drive
 	revived = err == EALREADY;
 
 	/* if the writer is revived and doesn't belong to a driver, it's an error */
-	if (revived && skin->kernel->writers[writer->info_index].driver_index >= skin->kernel->max_driver_count)
+	if (revived && skin_internal_writer_info(skin, writer->info_index)->driver_index >= skin->kernel->max_driver_count)
 		goto exit_revived_but_not_driver;
 
 	if ((err = skin_internal_driver_write_lock(&skin->kernel_locks)))
@@ -323,12 +315,16 @@ struct skin_driver *(skin_driver_add)(struct skin *skin, const struct skin_drive
 			goto exit_bad_details;
 		}
 
-		/* cache used sensor types */
-		if (_cache_sensor_types(&skin->kernel->drivers[driver->info_index], &details))
-		{
-			err = EINVAL;
+		/* cache used sensor types, and index the driver by them so users looking for a sensor type can find it */
+		if ((err = skin_internal_driver_write_lock(&skin->kernel_locks)))
+			goto exit_bad_details;
+		skin_internal_driver_unindex_types(skin, driver->info_index);
+		err = _cache_sensor_types(skin_internal_driver_info(skin, driver->info_index), &details)?EINVAL:0;
+		if (err == 0)
+			skin_internal_driver_index_types(skin, driver->info_index);
+		skin_internal_driver_write_unlock(&skin->kernel_locks);
+		if (err)
 			goto exit_bad_details;
-		}
 	}
 
 	/* store the pointer in internal memory */
@@ -377,15 +373,14 @@ void skin_driver_remove(struct skin_driver *driver)
 	if (driver == NULL || _sanity_check_skin(driver->skin) || _sanity_check_driver(driver))
 		return;
 
-	/* remove it from local book-keeping, making sure it had been added for book-keeping */
-	if (driver->index < driver->skin->drivers_mem_size)
-		if (driver == driver->skin->drivers[driver->index])
-			driver->skin->drivers[driver->index] = NULL;
+	/* remove it from local book-keeping */
+	_unstore_driver(driver->skin, driver);
 
 	locked = skin_internal_driver_write_lock(&driver->skin->kernel_locks) == 0;
 
-	/* mark it as inactive */
-	driver->skin->kernel->drivers[driver->info_index].active = false;
+	/* mark it as inactive, and free its slot if no users are attached to it */
+	skin_internal_driver_info(driver->skin, driver->info_index)->active = false;
+	skin_internal_driver_release(driver->skin, driver->info_index);
 
 	if (locked)
 		skin_internal_driver_write_unlock(&driver->skin->kernel_locks);
@@ -437,7 +432,7 @@ int skin_driver_get_attr(struct skin_driver *driver, struct skin_driver_attr *at
 	if ((err = skin_internal_driver_read_lock(&driver->skin->kernel_locks)))
 		return err;
 
-	*attr = driver->skin->kernel->drivers[driver->info_index].attr;
+	*attr = skin_internal_driver_info(driver->skin, driver->info_index)->attr;
 
 	skin_internal_driver_read_unlock(&driver->skin->kernel_locks);
 
@@ -36,10 +36,16 @@ struct skin_driver_info
 	skin_sensor_type_size sensor_type_count;
 	skin_sensor_type_id sensor_types[SKIN_CONFIG_MAX_SENSOR_TYPES];
 						/* sensor types handled by this driver */
+	skin_sensor_size sensor_type_sizes[SKIN_CONFIG_MAX_SENSOR_TYPES];
+						/* number of sensors of each type */
 	unsigned int users_attached;		/* number of users still attached */
 	uint16_t writer_index;			/* index to writer_info in skin kernel */
 	/* book keeping */
 	bool active;				/* whether driver is active */
+	bool used;				/* whether the slot is in use (active or with users still attached) */
+	uint16_t next;				/* next free driver, if not used */
+	uint32_t next_of_type[SKIN_CONFIG_MAX_SENSOR_TYPES];
+						/* next node in the sensor type index of each of sensor_types */
 };
 
 /* internal information on writers */
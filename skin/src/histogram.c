@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define URT_LOG_PREFIX "skin: "
+#include <skin_histogram.h>
+
+#define SUB_BUCKETS (1 << SKIN_HISTOGRAM_SUB_BUCKET_BITS)
+
+static unsigned int _bucket_of(urt_time value)
+{
+	unsigned int msb;
+	uint64_t v = value;
+
+	if (value < SUB_BUCKETS)
+		return value < 0?0:value;
+
+	/* find the power of two range of the value */
+#ifdef __KERNEL__
+	msb = fls64(v) - 1;
+#else
+	msb = 63 - __builtin_clzll(v);
+#endif
+	if (msb >= SKIN_HISTOGRAM_MAX_BITS)
+		return SKIN_HISTOGRAM_BUCKET_COUNT - 1;
+
+	/* the range is divided in SUB_BUCKETS buckets; the bits right below msb tell which one */
+	return (msb - SKIN_HISTOGRAM_SUB_BUCKET_BITS + 1) * SUB_BUCKETS
+		+ (unsigned int)((v >> (msb - SKIN_HISTOGRAM_SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+}
+
+urt_time skin_histogram_bucket_low(unsigned int bucket)
+{
+	unsigned int range = bucket / SUB_BUCKETS;
+
+	if (bucket >= SKIN_HISTOGRAM_BUCKET_COUNT)
+		bucket = SKIN_HISTOGRAM_BUCKET_COUNT - 1;
+	if (range == 0)
+		return bucket;
+
+	return (urt_time)(SUB_BUCKETS + bucket % SUB_BUCKETS) << (range - 1);
+}
+URT_EXPORT_SYMBOL(skin_histogram_bucket_low);
+
+urt_time skin_histogram_bucket_high(unsigned int bucket)
+{
+	unsigned int range = bucket / SUB_BUCKETS;
+
+	if (bucket >= SKIN_HISTOGRAM_BUCKET_COUNT)
+		bucket = SKIN_HISTOGRAM_BUCKET_COUNT - 1;
+	if (range == 0)
+		return bucket;
+
+	return skin_histogram_bucket_low(bucket) + ((urt_time)1 << (range - 1)) - 1;
+}
+URT_EXPORT_SYMBOL(skin_histogram_bucket_high);
+
+void skin_histogram_record(struct skin_histogram *hist, urt_time value)
+{
+	if (hist == NULL)
+		return;
+
+	++hist->counts[_bucket_of(value)];
+	++hist->total;
+}
+URT_EXPORT_SYMBOL(skin_histogram_record);
+
+urt_time skin_histogram_percentile(const struct skin_histogram *hist, uint32_t percentile)
+{
+	uint64_t target;
+	uint64_t seen = 0;
+	unsigned int i;
+
+	if (hist == NULL || hist->total == 0)
+		return 0;
+	if (percentile > 100000)
+		percentile = 100000;
+
+	/* the number of values that must be covered; ceil(total * percentile / 100000) */
+	target = hist->total * percentile + 99999;
+#if !defined(__KERNEL__) || BITS_PER_LONG == 64
+	target /= 100000;
+#else
+	/* in kernel space, for 32 bit architectures, 64 bit division is done with do_div */
+	do_div(target, 100000);
+#endif
+	if (target == 0)
+		target = 1;
+
+	for (i = 0; i < SKIN_HISTOGRAM_BUCKET_COUNT; ++i)
+	{
+		seen += hist->counts[i];
+		if (seen >= target)
+			return skin_histogram_bucket_high(i);
+	}
+
+	return skin_histogram_bucket_high(SKIN_HISTOGRAM_BUCKET_COUNT - 1);
+}
+URT_EXPORT_SYMBOL(skin_histogram_percentile);
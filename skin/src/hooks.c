@@ -53,3 +53,9 @@ DEFINE_SET_HOOK_FUNC(module, init)
 DEFINE_SET_HOOK_FUNC(module, clean)
 DEFINE_SET_HOOK_FUNC(patch, init)
 DEFINE_SET_HOOK_FUNC(patch, clean)
+DEFINE_SET_HOOK_FUNC(sensor_batch, init)
+DEFINE_SET_HOOK_FUNC(sensor_batch, clean)
+DEFINE_SET_HOOK_FUNC(module_batch, init)
+DEFINE_SET_HOOK_FUNC(module_batch, clean)
+DEFINE_SET_HOOK_FUNC(patch_batch, init)
+DEFINE_SET_HOOK_FUNC(patch_batch, clean)
@@ -24,6 +24,7 @@
 
 #define URT_LOG_PREFIX "skin: "
 #include "internal.h"
+#include "names.h"
 #ifndef __KERNEL__
 # include <pthread.h>
 # include <unistd.h>
@@ -195,6 +196,292 @@ int skin_internal_driver_read_unlock(struct skin_kernel_locks *locks)
 }
 #endif
 
+/*
+ * blocks of writer and driver information.  A block other than the first is created in a separate shared memory
+ * when all the slots are taken, and it is attached to by every skin that uses its slots.  If every skin attached to
+ * a block is freed, the block is removed while skin kernel still counts it.  Since then all its slots are free,
+ * so it is simply created anew if needed.
+ */
+#define DEFINE_BLOCK_FUNCTIONS(object, suffix, block_size)						\
+static void _init_##object##_block(struct skin_kernel *sk, struct skin_##object##_info *block, uint16_t b)	\
+{													\
+	uint16_t i, first = b * block_size;								\
+													\
+	/* chain the slots in order, so they are taken in order */					\
+	for (i = 0; i < block_size; ++i)								\
+		block[i].next = i + 1 < block_size?first + i + 1:SKIN_KERNEL_INVALID_INDEX;		\
+	sk->free_##object##s[b] = first;								\
+}													\
+													\
+static struct skin_##object##_info *_get_##object##_block(struct skin *skin, uint16_t b, bool create)	\
+{													\
+	char name[URT_NAME_LEN + 1];									\
+	struct skin_##object##_info *block;								\
+	int err;											\
+													\
+	skin_internal_name_set_indexed(name, skin->kernel_prefix, suffix, b);				\
+	if (create)											\
+	{												\
+		block = urt_shmem_new(name, sizeof(struct skin_##object##_info[block_size]), &err);	\
+		if (block)										\
+		{											\
+			memset(block, 0, sizeof(struct skin_##object##_info[block_size]));		\
+			_init_##object##_block(skin->kernel, block, b);					\
+		}											\
+	}												\
+	else												\
+		block = urt_shmem_attach(name, &err);							\
+													\
+	skin->object##_blocks[b] = block;								\
+	return block;											\
+}													\
+													\
+static uint16_t _claim_##object(struct skin *skin)							\
+{													\
+	struct skin_kernel *sk = skin->kernel;								\
+	uint16_t b, index;										\
+													\
+	for (b = 0; b < sk->object##_block_count; ++b)							\
+	{												\
+		if (sk->free_##object##s[b] == SKIN_KERNEL_INVALID_INDEX)				\
+			continue;									\
+		if (skin->object##_blocks[b] == NULL && _get_##object##_block(skin, b, false) == NULL	\
+				&& _get_##object##_block(skin, b, true) == NULL)			\
+			continue;									\
+		goto exit_found;									\
+	}												\
+													\
+	/* if all slots are taken, add a new block */							\
+	if (b >= SKIN_KERNEL_MAX_BLOCKS || (uint32_t)(b + 1) * block_size >= SKIN_KERNEL_INVALID_INDEX	\
+			|| _get_##object##_block(skin, b, true) == NULL)					\
+		return SKIN_KERNEL_INVALID_INDEX;							\
+	sk->max_##object##_count = (b + 1) * block_size;						\
+	skin_internal_write_barrier();									\
+	sk->object##_block_count = b + 1;								\
+exit_found:												\
+	index = sk->free_##object##s[b];								\
+	sk->free_##object##s[b] = skin_internal_##object##_info(skin, index)->next;			\
+	return index;											\
+}													\
+													\
+static void _free_##object(struct skin *skin, uint16_t index)						\
+{													\
+	uint16_t b = index / block_size;								\
+													\
+	skin_internal_##object##_info(skin, index)->next = skin->kernel->free_##object##s[b];		\
+	skin->kernel->free_##object##s[b] = index;							\
+}
+
+DEFINE_BLOCK_FUNCTIONS(writer, "KW", SKIN_KERNEL_WRITER_BLOCK_SIZE)
+DEFINE_BLOCK_FUNCTIONS(driver, "KD", SKIN_KERNEL_DRIVER_BLOCK_SIZE)
+
+void skin_internal_attach_kernel_blocks(struct skin *skin)
+{
+	struct skin_kernel *sk = skin->kernel;
+	uint16_t writer_block_count = sk->writer_block_count;
+	uint16_t driver_block_count = sk->driver_block_count;
+	uint16_t b;
+
+	/* make sure the blocks are seen after their count is */
+	skin_internal_read_barrier();
+
+	skin->writer_blocks[0] = sk->writers;
+	skin->driver_blocks[0] = sk->drivers;
+
+	/* if a block cannot be attached to, it has been removed and none of its slots are in use */
+	for (b = 1; b < writer_block_count; ++b)
+		if (skin->writer_blocks[b] == NULL)
+			_get_writer_block(skin, b, false);
+	for (b = 1; b < driver_block_count; ++b)
+		if (skin->driver_blocks[b] == NULL)
+			_get_driver_block(skin, b, false);
+}
+
+void skin_internal_detach_kernel_blocks(struct skin *skin)
+{
+	uint16_t b;
+
+	for (b = 1; b < SKIN_KERNEL_MAX_BLOCKS; ++b)
+	{
+		urt_shmem_detach(skin->writer_blocks[b]);
+		urt_shmem_detach(skin->driver_blocks[b]);
+		skin->writer_blocks[b] = NULL;
+		skin->driver_blocks[b] = NULL;
+	}
+}
+
+void skin_internal_init_kernel_indices(struct skin_kernel *sk)
+{
+	unsigned int i;
+
+	for (i = 0; i < SKIN_KERNEL_INDEX_BUCKETS; ++i)
+	{
+		sk->writers_by_prefix[i] = SKIN_KERNEL_INVALID_INDEX;
+		sk->drivers_by_sensor_type[i] = SKIN_KERNEL_INVALID_NODE;
+	}
+
+	for (i = 0; i < SKIN_KERNEL_MAX_BLOCKS; ++i)
+	{
+		sk->free_writers[i] = SKIN_KERNEL_INVALID_INDEX;
+		sk->free_drivers[i] = SKIN_KERNEL_INVALID_INDEX;
+	}
+
+	_init_writer_block(sk, sk->writers, 0);
+	_init_driver_block(sk, sk->drivers, 0);
+}
+
+static inline uint16_t *_writer_bucket(struct skin_kernel *sk, const char *prefix)
+{
+	return &sk->writers_by_prefix[skin_internal_name_hash_prefix(prefix) & (SKIN_KERNEL_INDEX_BUCKETS - 1)];
+}
+
+uint16_t skin_internal_writer_claim(struct skin *skin)
+{
+	skin_internal_attach_kernel_blocks(skin);
+	return _claim_writer(skin);
+}
+
+void skin_internal_writer_link(struct skin *skin, uint16_t writer_index)
+{
+	struct skin_writer_info *w = skin_internal_writer_info(skin, writer_index);
+	uint16_t *bucket = _writer_bucket(skin->kernel, w->attr.prefix);
+
+	w->used = true;
+	w->next = *bucket;
+	*bucket = writer_index;
+}
+
+void skin_internal_writer_release(struct skin *skin, uint16_t writer_index)
+{
+	struct skin_writer_info *w = skin_internal_writer_info(skin, writer_index);
+	uint16_t *link;
+
+	if (!w->used || w->active || w->readers_attached > 0)
+		return;
+
+	/* take it out of its hash chain */
+	for (link = _writer_bucket(skin->kernel, w->attr.prefix); *link != SKIN_KERNEL_INVALID_INDEX;
+			link = &skin_internal_writer_info(skin, *link)->next)
+		if (*link == writer_index)
+		{
+			*link = w->next;
+			break;
+		}
+
+	/* and put it in the free list */
+	w->used = false;
+	_free_writer(skin, writer_index);
+}
+
+uint16_t skin_internal_writer_find(struct skin *skin, const char *prefix, uint16_t from)
+{
+	uint16_t index;
+
+	/* the writers may be in blocks created after the last search */
+	if (from == SKIN_KERNEL_INVALID_INDEX)
+	{
+		skin_internal_attach_kernel_blocks(skin);
+		index = *_writer_bucket(skin->kernel, prefix);
+	}
+	else
+		index = skin_internal_writer_info(skin, from)->next;
+
+	/* the chain may contain other prefixes with the same hash */
+	while (index != SKIN_KERNEL_INVALID_INDEX
+			&& skin_internal_name_cmp_prefix(skin_internal_writer_info(skin, index)->attr.prefix, prefix) != 0)
+		index = skin_internal_writer_info(skin, index)->next;
+
+	return index;
+}
+
+uint16_t skin_internal_driver_claim(struct skin *skin)
+{
+	skin_internal_attach_kernel_blocks(skin);
+	return _claim_driver(skin);
+}
+
+void skin_internal_driver_release(struct skin *skin, uint16_t driver_index)
+{
+	struct skin_driver_info *d = skin_internal_driver_info(skin, driver_index);
+
+	if (!d->used || d->active || d->users_attached > 0)
+		return;
+
+	skin_internal_driver_unindex_types(skin, driver_index);
+
+	d->used = false;
+	_free_driver(skin, driver_index);
+}
+
+static inline uint32_t *_driver_type_bucket(struct skin_kernel *sk, skin_sensor_type_id type)
+{
+	return &sk->drivers_by_sensor_type[type & (SKIN_KERNEL_INDEX_BUCKETS - 1)];
+}
+
+static inline uint32_t *_driver_type_next(struct skin *skin, uint32_t node)
+{
+	return &skin_internal_driver_info(skin, node / SKIN_CONFIG_MAX_SENSOR_TYPES)->next_of_type[node % SKIN_CONFIG_MAX_SENSOR_TYPES];
+}
+
+void skin_internal_driver_index_types(struct skin *skin, uint16_t driver_index)
+{
+	struct skin_driver_info *d = skin_internal_driver_info(skin, driver_index);
+	skin_sensor_type_size i;
+
+	for (i = 0; i < d->sensor_type_count; ++i)
+	{
+		uint32_t *bucket = _driver_type_bucket(skin->kernel, d->sensor_types[i]);
+
+		d->next_of_type[i] = *bucket;
+		*bucket = (uint32_t)driver_index * SKIN_CONFIG_MAX_SENSOR_TYPES + i;
+	}
+}
+
+void skin_internal_driver_unindex_types(struct skin *skin, uint16_t driver_index)
+{
+	struct skin_driver_info *d = skin_internal_driver_info(skin, driver_index);
+	skin_sensor_type_size i;
+	uint32_t *link;
+
+	for (i = 0; i < d->sensor_type_count; ++i)
+	{
+		uint32_t node = (uint32_t)driver_index * SKIN_CONFIG_MAX_SENSOR_TYPES + i;
+
+		/* if the types were never indexed, the node is simply not found */
+		for (link = _driver_type_bucket(skin->kernel, d->sensor_types[i]); *link != SKIN_KERNEL_INVALID_NODE;
+				link = _driver_type_next(skin, *link))
+			if (*link == node)
+			{
+				*link = d->next_of_type[i];
+				break;
+			}
+	}
+}
+
+uint16_t skin_internal_driver_find_by_type(struct skin *skin, skin_sensor_type_id type, uint32_t *node)
+{
+	/* the drivers may be in blocks created after the last search */
+	if (*node == SKIN_KERNEL_INVALID_NODE)
+	{
+		skin_internal_attach_kernel_blocks(skin);
+		*node = *_driver_type_bucket(skin->kernel, type);
+	}
+	else
+		*node = *_driver_type_next(skin, *node);
+
+	/* the chain may contain other types with the same hash */
+	while (*node != SKIN_KERNEL_INVALID_NODE)
+	{
+		struct skin_driver_info *d = skin_internal_driver_info(skin, *node / SKIN_CONFIG_MAX_SENSOR_TYPES);
+
+		if (d->sensor_types[*node % SKIN_CONFIG_MAX_SENSOR_TYPES] == type)
+			return *node / SKIN_CONFIG_MAX_SENSOR_TYPES;
+		*node = *_driver_type_next(skin, *node);
+	}
+
+	return SKIN_KERNEL_INVALID_INDEX;
+}
+
 void skin_internal_wait_termination(bool *running)
 {
 #if SKIN_CONFIG_STOP_MIN_WAIT > 0
@@ -220,6 +507,87 @@ void skin_internal_signal_all_requests(urt_sem *req, urt_sem *res)
 		urt_sem_post(res);
 }
 
+/* after this many failed checks, the sequence reader sleeps instead of busy waiting */
+#define SEQ_MAX_SPINS 100
+#define SEQ_SLEEP_TIME 10000
+
+uint32_t skin_internal_seq_read_begin(volatile uint32_t *seq)
+{
+	unsigned int spins = 0;
+	uint32_t start;
+
+	/*
+	 * wait for the updating task to finish.  If the caller has a higher priority and has preempted that task on the
+	 * same CPU, busy waiting would never end, so sleep a little to let it finish
+	 */
+	while ((start = *seq) & 1)
+		if (++spins > SEQ_MAX_SPINS)
+			urt_sleep(SEQ_SLEEP_TIME);
+
+	skin_internal_read_barrier();
+	return start;
+}
+
+bool skin_internal_seq_read_retry(volatile uint32_t *seq, uint32_t start)
+{
+	skin_internal_read_barrier();
+	return *seq != start;
+}
+
+struct skin_shared_histograms *skin_internal_attach_histograms(struct skin_writer_info *w)
+{
+	char name[URT_NAME_LEN + 1];
+
+	skin_internal_name_set(name, w->attr.prefix, "HSG");
+	return urt_shmem_attach(name);
+}
+
+void skin_internal_detach_histograms(struct skin_shared_histograms *histograms)
+{
+	urt_shmem_detach(histograms);
+}
+
+/* take a consistent snapshot of the statistics the writer and its readers have shared */
+void skin_internal_get_writer_statistics(struct skin_writer_info *w, struct skin_shared_histograms *histograms,
+		struct skin_writer_statistics *stats, struct skin_histogram *hist)
+{
+	uint32_t seq;
+
+	do
+	{
+		seq = skin_internal_seq_read_begin(&w->stats_seq);
+		*stats = w->stats;
+		if (hist && histograms)
+			*hist = histograms->write_time;
+	} while (skin_internal_seq_read_retry(&w->stats_seq, seq));
+
+	if (hist && histograms == NULL)
+		*hist = (struct skin_histogram){0};
+}
+
+bool skin_internal_get_reader_statistics(struct skin_writer_info *w, struct skin_shared_histograms *histograms,
+		uint16_t slot, struct skin_reader_statistics *stats, struct skin_histogram *hist)
+{
+	struct skin_reader_stats_slot *r = &w->reader_stats[slot];
+	uint32_t seq;
+
+	if (!r->used)
+		return false;
+
+	do
+	{
+		seq = skin_internal_seq_read_begin(&r->seq);
+		*stats = r->stats;
+		if (hist && histograms)
+			*hist = histograms->read_times[slot];
+	} while (skin_internal_seq_read_retry(&r->seq, seq));
+
+	if (hist && histograms == NULL)
+		*hist = (struct skin_histogram){0};
+
+	return true;
+}
+
 bool skin_internal_writer_is_active(struct skin *skin, uint16_t writer_index)
 {
 	struct skin_writer_info *writer_info;
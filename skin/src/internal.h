@@ -35,6 +35,26 @@ struct skin_writer;
 struct skin_reader;
 struct skin_driver;
 struct skin_user;
+struct skin_reader_group;
+struct skin_reader_pool;
+
+/*
+ * size of the hash tables in skin_kernel, which must be a power of two.  The tables are chained through the
+ * writer and driver information, so they can hold any number of objects, but lookups get slower if the number
+ * of writers or drivers with distinct sensor types is much larger than the table size.
+ */
+#define SKIN_KERNEL_INDEX_BUCKETS 256
+#define SKIN_KERNEL_INVALID_INDEX 0xFFFF	/* end of a list of writers or drivers */
+#define SKIN_KERNEL_INVALID_NODE 0xFFFFFFFF	/* end of a list of (driver, sensor type) nodes */
+
+/*
+ * the writer and driver information are kept in blocks.  The first block of each is part of skin_kernel, and
+ * the rest are created in separate shared memories when all slots are taken.  The number of blocks is limited
+ * so that their names are distinct and the indices fit in 16 bits.
+ */
+#define SKIN_KERNEL_WRITER_BLOCK_SIZE (SKIN_CONFIG_MAX_DRIVERS + SKIN_CONFIG_MAX_SERVICES)
+#define SKIN_KERNEL_DRIVER_BLOCK_SIZE SKIN_CONFIG_MAX_DRIVERS
+#define SKIN_KERNEL_MAX_BLOCKS 32
 
 /* shared memory between all instances */
 struct skin_kernel
@@ -50,13 +70,32 @@ struct skin_kernel
 	bool initialized;		/* whether this structure is initialized */
 	bool initialization_failed;	/* whether initialization has failed */
 
-	uint16_t max_driver_count;	/* maximum number of drivers (same as SKIN_CONFIG_MAX_DRIVERS) */
-	uint16_t max_writer_count;	/* maximum total number of writers (sum of SKIN_CONFIG_MAX_DRIVERS and SERVICES */
-	struct skin_driver_info drivers[SKIN_CONFIG_MAX_DRIVERS];
+	uint16_t max_driver_count;	/* current number of driver slots, a multiple of SKIN_KERNEL_DRIVER_BLOCK_SIZE */
+	uint16_t max_writer_count;	/* current number of writer slots, a multiple of SKIN_KERNEL_WRITER_BLOCK_SIZE */
+	uint16_t driver_block_count;	/* number of driver blocks, including `drivers` */
+	uint16_t writer_block_count;	/* number of writer blocks, including `writers` */
+	struct skin_driver_info drivers[SKIN_KERNEL_DRIVER_BLOCK_SIZE];
 					/*
 					 * driver information.  Used by users to discover the skin and
 					 * read the skin structure as well as sensor responses
 					 */
+	/*
+	 * indices over the driver and writer slots.  Free slots are kept in a list per block, so getting a new
+	 * one doesn't need a search.  Writers in use are hashed by their prefix, and drivers in use by the sensor
+	 * types they provide, so readers and users can find them without looking at every slot.  The writer
+	 * indices are protected by the global lock and the driver indices by the driver lock.
+	 */
+	uint16_t free_writers[SKIN_KERNEL_MAX_BLOCKS];
+					/* head of the list of free writers of each block, linked through writer_info.next */
+	uint16_t free_drivers[SKIN_KERNEL_MAX_BLOCKS];
+					/* head of the list of free drivers of each block, linked through driver_info.next */
+	uint16_t writers_by_prefix[SKIN_KERNEL_INDEX_BUCKETS];
+					/* heads of writer lists with the same prefix hash */
+	uint32_t drivers_by_sensor_type[SKIN_KERNEL_INDEX_BUCKETS];
+					/*
+					 * heads of lists of driver nodes with the same sensor type hash.  A node
+					 * is driver_index * SKIN_CONFIG_MAX_SENSOR_TYPES + index in its sensor_types
+					 */
 	struct skin_writer_info writers[];
 					/*
 					 * writer information.  Driver and service writers may be interleaved.
@@ -79,6 +118,13 @@ struct skin
 	/* shared skin data */
 	struct skin_kernel *kernel;
 	struct skin_kernel_locks kernel_locks;
+	char kernel_prefix[URT_NAME_LEN - 3 + 1];
+	struct skin_writer_info *writer_blocks[SKIN_KERNEL_MAX_BLOCKS];
+	struct skin_driver_info *driver_blocks[SKIN_KERNEL_MAX_BLOCKS];
+					/*
+					 * the blocks of skin kernel attached to by this skin, the first of
+					 * each being part of skin_kernel.  They are NULL if not attached
+					 */
 
 	/* individual book-keeping */
 
@@ -86,7 +132,8 @@ struct skin
 	 * a list of every object created (writers, readers, drivers and users), so they could be
 	 * cleaned up automatically on skin_free.  These lists are not protected by locks, therefore
 	 * object creation, cleanup and access must be mutually exclusive.  If that cannot be
-	 * guaranteed, the user must use locks herself.
+	 * guaranteed, the user must use locks herself.  The lists are dense, i.e. they have no NULL
+	 * elements up to their count.
 	 */
 	struct skin_writer **writers;
 	struct skin_reader **readers;
@@ -96,6 +143,46 @@ struct skin
 	size_t readers_mem_size;
 	size_t drivers_mem_size;
 	size_t users_mem_size;
+	size_t writer_count;
+	size_t reader_count;
+	size_t driver_count;
+	size_t user_count;
+
+	/* reader groups, kept similarly to the objects above */
+	struct skin_reader_group **reader_groups;
+	size_t reader_groups_mem_size;
+	size_t reader_group_count;
+
+	/*
+	 * cached information on the sensors of all users, updated whenever a user is attached or detached
+	 * so that skin-wide queries don't need to go over all users.
+	 */
+	skin_sensor_size sensor_count;
+	skin_module_size module_count;
+	skin_patch_size patch_count;
+	struct skin_sensor_type_entry
+	{
+		skin_sensor_type_id type;
+		struct skin_user *user;		/* the first user with sensors of this type */
+		unsigned int user_count;	/* number of users with sensors of this type */
+	} *sensor_types;			/* distinct sensor types among all users */
+	skin_sensor_type_size sensor_type_count;
+	size_t sensor_types_mem_size;
+
+	/* number of users attached to each driver of the skin kernel, grown as needed */
+	unsigned int *driver_users;
+	size_t driver_users_mem_size;
+
+	/* size of per-sensor extra data of the users created by skin_load and skin_update */
+	size_t sensor_data_size;
+	/* whether the users created by skin_load and skin_update keep their responses only contiguously */
+	bool contiguous_responses;
+
+	/* the group the readers created by skin_load and skin_update join, if any */
+	struct skin_reader_group *reader_group;
+
+	/* the workers reading soft readers attached from now on, if any */
+	struct skin_reader_pool *soft_reader_pool;
 
 	/* hooks */
 	skin_hook_writer writer_init_hook;	void *writer_init_user_data;
@@ -112,6 +199,12 @@ struct skin
 	skin_hook_module module_clean_hook;	void *module_clean_user_data;
 	skin_hook_patch patch_init_hook;	void *patch_init_user_data;
 	skin_hook_patch patch_clean_hook;	void *patch_clean_user_data;
+	skin_hook_sensor_batch sensor_batch_init_hook;		void *sensor_batch_init_user_data;
+	skin_hook_sensor_batch sensor_batch_clean_hook;		void *sensor_batch_clean_user_data;
+	skin_hook_module_batch module_batch_init_hook;		void *module_batch_init_user_data;
+	skin_hook_module_batch module_batch_clean_hook;		void *module_batch_clean_user_data;
+	skin_hook_patch_batch patch_batch_init_hook;		void *patch_batch_init_user_data;
+	skin_hook_patch_batch patch_batch_clean_hook;		void *patch_batch_clean_user_data;
 
 #ifndef NDEBUG
 	void *log_file;
@@ -143,45 +236,191 @@ extern rwlock_t skin_internal_global_lock;
 extern rwlock_t skin_internal_driver_lock;
 #endif
 
+/*
+ * memory barriers for lock-free synchronization over shared memory.  Note that the skin kernel may be shared
+ * between kernel and user spaces, so these only order plain memory accesses and don't require special types.
+ */
+#ifdef __KERNEL__
+# define skin_internal_write_barrier() smp_wmb()
+# define skin_internal_read_barrier() smp_rmb()
+#else
+# define skin_internal_write_barrier() __atomic_thread_fence(__ATOMIC_RELEASE)
+# define skin_internal_read_barrier() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#endif
+
+/* atomic operations on data shared between processes.  These are compiler builtins, so they are usable in the kernel too */
+#define skin_internal_atomic_inc(p) __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST)
+#define skin_internal_atomic_xchg(p, v) __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST)
+
+/* decrement a counter unless it is zero.  Returns whether it was decremented */
+static inline bool skin_internal_atomic_dec_if_positive(unsigned int *p)
+{
+	unsigned int v = __atomic_load_n(p, __ATOMIC_SEQ_CST);
+
+	while (v > 0)
+		if (__atomic_compare_exchange_n(p, &v, v - 1, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+			return true;
+	return false;
+}
+
+/*
+ * sequence counters for data updated by a single task and read from any context, such as statistics.  The task
+ * surrounds its updates with write_begin and write_end, which never block.  The readers copy the data between
+ * read_begin and read_retry, and repeat if read_retry returns true.
+ */
+#define skin_internal_seq_write_begin(seq)		\
+	do {						\
+		++*(seq);				\
+		skin_internal_write_barrier();		\
+	} while (0)
+#define skin_internal_seq_write_end(seq)		\
+	do {						\
+		skin_internal_write_barrier();		\
+		++*(seq);				\
+	} while (0)
+uint32_t skin_internal_seq_read_begin(volatile uint32_t *seq);
+bool skin_internal_seq_read_retry(volatile uint32_t *seq, uint32_t start);
+
+/*
+ * take a consistent snapshot of shared statistics of a writer or reader.  The histograms are kept in a shared memory
+ * of the writer, which needs to be attached to first if they are needed.  hist may be NULL if not needed, otherwise
+ * if histograms is NULL (e.g. if attach failed), it is zeroed.
+ */
+struct skin_shared_histograms *skin_internal_attach_histograms(struct skin_writer_info *w);
+void skin_internal_detach_histograms(struct skin_shared_histograms *histograms);
+void skin_internal_get_writer_statistics(struct skin_writer_info *w, struct skin_shared_histograms *histograms,
+		struct skin_writer_statistics *stats, struct skin_histogram *hist);
+bool skin_internal_get_reader_statistics(struct skin_writer_info *w, struct skin_shared_histograms *histograms,
+		uint16_t slot, struct skin_reader_statistics *stats, struct skin_histogram *hist);
+
+/*
+ * access to writer and driver information by index.  The block of an index that is taken from the skin kernel
+ * indices, or from an object of this skin, is always attached.  Other indices (such as when going over all slots)
+ * may be in blocks that are not attached, in which case NULL is returned.  skin_internal_attach_kernel_blocks
+ * attaches to the blocks created by other processes.
+ */
+static inline struct skin_writer_info *skin_internal_writer_info(struct skin *skin, uint16_t index)
+{
+	struct skin_writer_info *block = skin->writer_blocks[index / SKIN_KERNEL_WRITER_BLOCK_SIZE];
+	return block?&block[index % SKIN_KERNEL_WRITER_BLOCK_SIZE]:NULL;
+}
+
+static inline struct skin_driver_info *skin_internal_driver_info(struct skin *skin, uint16_t index)
+{
+	struct skin_driver_info *block = skin->driver_blocks[index / SKIN_KERNEL_DRIVER_BLOCK_SIZE];
+	return block?&block[index % SKIN_KERNEL_DRIVER_BLOCK_SIZE]:NULL;
+}
+
+void skin_internal_attach_kernel_blocks(struct skin *skin);
+void skin_internal_detach_kernel_blocks(struct skin *skin);
+
+/* maintenance of skin kernel indices.  The functions on writers need the global lock and the ones on drivers the driver lock */
+void skin_internal_init_kernel_indices(struct skin_kernel *sk);
+/*
+ * take a free writer slot, creating a new block if all are taken, or return SKIN_KERNEL_INVALID_INDEX if not possible.
+ * Once initialized, the slot is hashed with writer_link
+ */
+uint16_t skin_internal_writer_claim(struct skin *skin);
+void skin_internal_writer_link(struct skin *skin, uint16_t writer_index);
+/* return the writer slot to the free list if it is no longer active and has no readers */
+void skin_internal_writer_release(struct skin *skin, uint16_t writer_index);
+/*
+ * find the next writer in use with the given prefix, starting after `from`, or from the beginning if `from` is
+ * SKIN_KERNEL_INVALID_INDEX.  Returns SKIN_KERNEL_INVALID_INDEX if there are no more
+ */
+uint16_t skin_internal_writer_find(struct skin *skin, const char *prefix, uint16_t from);
+/* similar to writer functions, but for drivers.  Drivers are indexed by their sensor types after they are cached */
+uint16_t skin_internal_driver_claim(struct skin *skin);
+void skin_internal_driver_release(struct skin *skin, uint16_t driver_index);
+void skin_internal_driver_index_types(struct skin *skin, uint16_t driver_index);
+void skin_internal_driver_unindex_types(struct skin *skin, uint16_t driver_index);
+/*
+ * find the next driver in use that provides the given sensor type.  `node` keeps the position of the search and
+ * must be initialized to SKIN_KERNEL_INVALID_NODE.  Returns SKIN_KERNEL_INVALID_INDEX if there are no more
+ */
+uint16_t skin_internal_driver_find_by_type(struct skin *skin, skin_sensor_type_id type, uint32_t *node);
+
+/* number of users of this skin attached to a driver, which is used to avoid attaching to the same driver twice */
+unsigned int skin_internal_local_users_of_driver(struct skin *skin, uint16_t driver_index);
+
 /* some functionality used by more than one module */
 void skin_internal_wait_termination(bool *running);
 void skin_internal_signal_all_requests(urt_sem *req, urt_sem *res);
-#define SKIN_DEFINE_STORE_FUNCTION(object)					\
+/*
+ * the lists of objects are kept dense, i.e. the first object##_count elements are all valid, and each object
+ * knows its position in the list.  New objects are appended, and removed objects are replaced by the last object
+ * of the list, so both are done in constant time.  The users are an exception, since their order determines the
+ * order of the sensors among all sensors.  For them, the ordered variant takes removed objects out by shifting
+ * the rest of the list, which keeps the order of the objects as they were created.
+ *
+ * Either way, removing an object moves other objects to lower indices.  Code iterating over these lists (such as
+ * OBJECT_ITERATE in iterators.c) can handle removal of the object currently being visited, by visiting the same
+ * index again, but not removal of any other object, which could cause an object to be skipped.
+ */
+#define SKIN_DEFINE_APPEND_FUNCTION_(object)					\
 static void _store_##object(struct skin *skin, struct skin_##object *object)	\
 {										\
-	size_t i;								\
 	void *enlarged;								\
 	size_t size = skin->object##s_mem_size, new_size;			\
 										\
-	for (i = 0; i < size; ++i)						\
-		if (skin->object##s[i] == NULL)					\
-		{								\
-			skin->object##s[i] = object;				\
-			object->index = i;					\
+	/* if full, try to increase memory size */				\
+	if (skin->object##_count >= size)					\
+	{									\
+		new_size = 2 * size;						\
+		enlarged = urt_mem_resize(skin->object##s,			\
+				size * sizeof *skin->object##s,			\
+				new_size * sizeof *skin->object##s);		\
+										\
+		/*								\
+		 * if not enough memory, then let them continue with		\
+		 * having the object, but it won't get cleaned up		\
+		 */								\
+		if (enlarged == NULL)						\
 			return;							\
-		}								\
 										\
-	/* if not found, try to increase memory size */				\
-	new_size = 2 * size;							\
-	enlarged = urt_mem_resize(skin->object##s,				\
-			size * sizeof *skin->object##s,				\
-			new_size * sizeof *skin->object##s);			\
+		skin->object##s = enlarged;					\
+		skin->object##s_mem_size = new_size;				\
+	}									\
+										\
+	object->index = skin->object##_count;					\
+	skin->object##s[skin->object##_count++] = object;			\
+}
+
+/* whether the object has been added for book-keeping */
+#define SKIN_IS_STORED_(object)							\
+	(object->index < skin->object##_count && skin->object##s[object->index] == object)
+
+#define SKIN_DEFINE_STORE_FUNCTION(object)					\
+SKIN_DEFINE_APPEND_FUNCTION_(object)						\
+										\
+static void _unstore_##object(struct skin *skin, struct skin_##object *object)	\
+{										\
+	struct skin_##object *last;						\
 										\
-	/*									\
-	 * if not enough memory, then let them continue with			\
-	 * having the object, but it won't get cleaned up			\
-	 */									\
-	if (enlarged == NULL)							\
+	if (!SKIN_IS_STORED_(object))						\
 		return;								\
 										\
-	skin->object##s = enlarged;						\
-	skin->object##s_mem_size = new_size;					\
-	for (i = size; i < new_size; ++i)					\
-		skin->object##s[i] = NULL;					\
+	last = skin->object##s[--skin->object##_count];				\
+	skin->object##s[object->index] = last;					\
+	last->index = object->index;						\
+}
+
+#define SKIN_DEFINE_ORDERED_STORE_FUNCTION(object)				\
+SKIN_DEFINE_APPEND_FUNCTION_(object)						\
+										\
+static void _unstore_##object(struct skin *skin, struct skin_##object *object)	\
+{										\
+	size_t i;								\
+										\
+	if (!SKIN_IS_STORED_(object))						\
+		return;								\
 										\
-	/* place the object in the beginning of the empty space just created */	\
-	skin->object##s[size] = object;						\
-	object->index = size;							\
+	for (i = object->index; i + 1 < skin->object##_count; ++i)		\
+	{									\
+		skin->object##s[i] = skin->object##s[i + 1];			\
+		skin->object##s[i]->index = i;					\
+	}									\
+	--skin->object##_count;							\
 }
 bool skin_internal_writer_is_active(struct skin *skin, uint16_t writer_index);
 bool skin_internal_driver_is_active(struct skin *skin, uint16_t driver_index);
@@ -52,7 +52,7 @@ static int _sanity_check_module(struct skin_module *module)
 	return module == NULL || module->sensors == NULL?-1:0;
 }
 
-#define OBJECT_ITERATE(objects)								\
+#define OBJECT_ITERATE(object, objects)								\
 do {											\
 	size_t i;									\
 	int ret = 0;									\
@@ -60,15 +60,23 @@ do {											\
 	if (_sanity_check_skin(skin) || callback == NULL)				\
 		return -1;								\
 											\
-	for (i = 0; i < skin->objects##_mem_size; ++i)					\
+	/*										\
+	 * the callback may remove the object, which brings another object to	\
+	 * its place in the list, in which case the same index is visited again.	\
+	 * Removing any other object, however, would move an object not yet		\
+	 * visited to an index already passed, so that object would be skipped.		\
+	 * Callbacks are therefore allowed to remove only the current object.		\
+	 */										\
+	for (i = 0; i < skin->object##_count; )					\
 	{										\
-		if (skin->objects[i] == NULL)						\
-			continue;							\
-		if (callback(skin->objects[i], user_data))				\
+		struct skin_##object *obj = skin->objects[i];				\
+		if (callback(obj, user_data))						\
 		{									\
 			ret = -1;							\
 			break;								\
 		}									\
+		if (i < skin->object##_count && skin->objects[i] == obj)		\
+			++i;								\
 	}										\
 											\
 	return ret;									\
@@ -82,10 +90,8 @@ do {											\
 	if (_sanity_check_skin(skin) || callback == NULL)				\
 		return -1;								\
 											\
-	for (i = 0; i < skin->users_mem_size; ++i)					\
+	for (i = 0; i < skin->user_count; ++i)						\
 	{										\
-		if (skin->users[i] == NULL)						\
-			continue;							\
 		if (skin_user_for_each_##datum(skin->users[i], callback, user_data))	\
 		{									\
 			ret = -1;							\
@@ -126,25 +132,25 @@ do {											\
 
 int (skin_for_each_writer)(struct skin *skin, skin_callback_writer callback, void *user_data, ...)
 {
-	OBJECT_ITERATE(writers);
+	OBJECT_ITERATE(writer, writers);
 }
 URT_EXPORT_SYMBOL(skin_for_each_writer);
 
 int (skin_for_each_reader)(struct skin *skin, skin_callback_reader callback, void *user_data, ...)
 {
-	OBJECT_ITERATE(readers);
+	OBJECT_ITERATE(reader, readers);
 }
 URT_EXPORT_SYMBOL(skin_for_each_reader);
 
 int (skin_for_each_driver)(struct skin *skin, skin_callback_driver callback, void *user_data, ...)
 {
-	OBJECT_ITERATE(drivers);
+	OBJECT_ITERATE(driver, drivers);
 }
 URT_EXPORT_SYMBOL(skin_for_each_driver);
 
 int (skin_for_each_user)(struct skin *skin, skin_callback_user callback, void *user_data, ...)
 {
-	OBJECT_ITERATE(users);
+	OBJECT_ITERATE(user, users);
 }
 URT_EXPORT_SYMBOL(skin_for_each_user);
 
@@ -166,51 +172,23 @@ int (skin_for_each_patch)(struct skin *skin, skin_callback_patch callback, void
 }
 URT_EXPORT_SYMBOL(skin_for_each_patch);
 
-static bool _sensor_type_is_new(struct skin *skin, size_t cur_user, skin_sensor_type_id cur_type)
-{
-	size_t i;
-	skin_sensor_type_id t;
-	for (i = 0; i < cur_user; ++i)
-	{
-		if (skin->users[i] == NULL)
-			continue;
-		for (t = 0; t < skin->users[i]->sensor_type_count; ++t)
-			if (skin->users[cur_user]->sensor_types[cur_type].type
-					== skin->users[i]->sensor_types[t].type)
-				return false;
-	}
-	return true;
-}
-
 int (skin_for_each_sensor_type)(struct skin *skin, skin_callback_sensor_type callback, void *user_data, ...)
 {
-	size_t i;
-	skin_sensor_type_id t;
-	int ret = 0;
+	skin_sensor_type_size t;
 
 	if (_sanity_check_skin(skin) || callback == NULL)
 		return -1;
 
-	for (i = 0; i < skin->users_mem_size; ++i)
-	{
-		if (_sanity_check_user(skin->users[i]))
-			continue;
-		for (t = 0; t < skin->users[i]->sensor_type_count; ++t)
-		{
-			/* make sure this sensor type is new */
-			if (!_sensor_type_is_new(skin, i, t))
-				continue;
-
-			/* construct a sensor type and call the callback for it */
-			if (callback(&(struct skin_sensor_type){
-						.id = skin->users[i]->sensor_types[t].type,
-						.user = skin->users[i],
-					}, user_data))
-				return -1;
-		}
-	}
+	/* the distinct sensor types are kept up to date as users are attached and detached */
+	for (t = 0; t < skin->sensor_type_count; ++t)
+		/* construct a sensor type and call the callback for it */
+		if (callback(&(struct skin_sensor_type){
+					.id = skin->sensor_types[t].type,
+					.user = skin->sensor_types[t].user,
+				}, user_data))
+			return -1;
 
-	return ret;
+	return 0;
 }
 URT_EXPORT_SYMBOL(skin_for_each_sensor_type);
 
@@ -218,23 +196,31 @@ int (skin_for_each_sensor_of_type)(struct skin *skin, skin_sensor_type_id type,
 		skin_callback_sensor callback, void *user_data, ...)
 {
 	size_t i;
-	int ret = 0;
+	skin_sensor_size j;
 
 	if (_sanity_check_skin(skin) || callback == NULL)
 		return -1;
 
-	for (i = 0; i < skin->users_mem_size; ++i)
+	for (i = 0; i < skin->user_count; ++i)
 	{
-		if (skin->users[i] == NULL)
+		struct skin_user *user = skin->users[i];
+		const skin_sensor_id *sensors;
+		skin_sensor_size count;
+
+		if (_sanity_check_user(user))
+			continue;
+
+		/* users without sensors of this type are skipped */
+		sensors = skin_user_get_sensors_of_type(user, type, &count);
+		if (sensors == NULL)
 			continue;
-		if (skin_user_for_each_sensor_of_type(skin->users[i], type, callback, user_data))
-		{
-			ret = -1;
-			break;
-		}
+
+		for (j = 0; j < count; ++j)
+			if (callback(&user->sensors[sensors[j]], user_data))
+				return -1;
 	}
 
-	return ret;
+	return 0;
 }
 URT_EXPORT_SYMBOL(skin_for_each_sensor_of_type);
 
@@ -278,22 +264,19 @@ URT_EXPORT_SYMBOL(skin_user_for_each_sensor_type);
 int (skin_user_for_each_sensor_of_type)(struct skin_user *user, skin_sensor_type_id type,
 		skin_callback_sensor callback, void *user_data, ...)
 {
-	skin_sensor_type_id t;
-	skin_sensor_id i;
+	const skin_sensor_id *sensors;
+	skin_sensor_size count;
+	skin_sensor_size i;
 
 	if (_sanity_check_user(user) || callback == NULL)
 		return -1;
 
-	/* find the type */
-	for (t = 0; t < user->sensor_type_count; ++t)
-		if (user->sensor_types[t].type == type)
-			break;
-
-	if (t >= user->sensor_type_count)
+	sensors = skin_user_get_sensors_of_type(user, type, &count);
+	if (sensors == NULL)
 		return -1;
 
-	for (i = user->sensor_types[t].first_sensor; i < user->driver_attr.sensor_count; i = user->sensors[i].next_of_type)
-		if (callback(&user->sensors[i], user_data))
+	for (i = 0; i < count; ++i)
+		if (callback(&user->sensors[sensors[i]], user_data))
 			return -1;
 
 	return 0;
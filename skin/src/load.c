@@ -28,6 +28,7 @@
 #include "internal.h"
 #include "user_internal.h"
 #include "reader_internal.h"
+#include "reader_group_internal.h"
 
 static int _sanity_check_skin(struct skin *skin)
 {
@@ -36,34 +37,44 @@ static int _sanity_check_skin(struct skin *skin)
 		|| skin->drivers == NULL || skin->users == NULL?-1:0;
 }
 
+/* the group the readers are to join, if there is one and it would read them with the period they are asked for */
+static struct skin_reader_group *_load_group(struct skin *skin, const urt_task_attr *task_attr)
+{
+	struct skin_reader_group *group = skin->reader_group;
+
+	return group && !task_attr->soft && task_attr->period == group->period?group:NULL;
+}
+
 int skin_load(struct skin *skin, const urt_task_attr *task_attr)
 {
-	size_t i, j;
-	struct skin_driver_info *drivers;
-	struct skin_writer_info *writers;
+	size_t i;
 	int error = 0;
 	unsigned int attached = 0;
+	struct skin_reader_group *group;
 
 	if (_sanity_check_skin(skin) || task_attr == NULL)
 		return EINVAL;
 
-	drivers = skin->kernel->drivers;
-	writers = skin->kernel->writers;
+	group = _load_group(skin, task_attr);
 
 	/* go over all present drivers and attach to the active ones */
 	for (i = 0; i < skin->kernel->max_driver_count; ++i)
 	{
 		/* check to see if driver is active and if so get its writer prefix */
+		struct skin_driver_info *driver_info;
+		struct skin_user *user;
 		bool active;
-		bool already_attached = false;
 		char reader_prefix[URT_NAME_LEN - 3 + 1];
 
 		if ((error = skin_internal_driver_read_lock(&skin->kernel_locks)))
 			continue;
-		active = drivers[i].active;
+		/* the drivers may be in blocks created by other processes */
+		skin_internal_attach_kernel_blocks(skin);
+		driver_info = skin_internal_driver_info(skin, i);
+		active = driver_info && driver_info->active;
 		if (active)
 		{
-			strncpy(reader_prefix, writers[drivers[i].writer_index].attr.prefix, URT_NAME_LEN - 3);
+			strncpy(reader_prefix, skin_internal_writer_info(skin, driver_info->writer_index)->attr.prefix, URT_NAME_LEN - 3);
 			reader_prefix[URT_NAME_LEN - 3] = '\0';
 		}
 		skin_internal_driver_read_unlock(&skin->kernel_locks);
@@ -72,20 +83,26 @@ int skin_load(struct skin *skin, const urt_task_attr *task_attr)
 			continue;
 
 		/* make sure we aren't already attached to this driver */
-		for (j = 0; j < skin->users_mem_size; ++j)
-			if (skin->users[j] && skin->users[j]->driver_index == i)
-			{
-				already_attached = true;
-				break;
-			}
-
-		if (already_attached)
+		if (skin_internal_local_users_of_driver(skin, i) > 0)
+			continue;
+
+		/* try to attach to that prefix.  If there is a group, the reader has no task of its own and joins the group */
+		user = skin_driver_attach(skin, &(struct skin_user_attr){
+					.sensor_data_size = skin->sensor_data_size,
+					.contiguous_responses = skin->contiguous_responses,
+				},
+				&(struct skin_reader_attr) { .name = reader_prefix, .pull = group != NULL },
+				task_attr, &(struct skin_user_callbacks){0}, &error);
+		if (user == NULL)
+			continue;
+
+		if (group && (error = skin_reader_join_group(user->reader, group)))
+		{
+			skin_driver_detach(user);
 			continue;
+		}
 
-		/* try to attach to that prefix */
-		if (skin_driver_attach(skin, &(struct skin_user_attr){0}, &(struct skin_reader_attr) { .name = reader_prefix },
-					task_attr, &(struct skin_user_callbacks){0}, &error) != NULL)
-			++attached;
+		++attached;
 	}
 
 	/* if at least one has been attached, call it a success */
@@ -111,38 +128,40 @@ void skin_unload(struct skin *skin)
 	 * Furthermore, to make sure readers don't falsely read because the
 	 * buffers get unlocked, set the writers also as inactive in advance.
 	 */
-	for (i = 0; i < skin->writers_mem_size; ++i)
-		if (skin->writers[i])
-		{
-			skin->kernel->writers[skin->writers[i]->info_index].active = false;
-			skin->writers[i]->must_stop = 1;
-		}
-	for (i = 0; i < skin->readers_mem_size; ++i)
-		if (skin->readers[i])
-			skin->readers[i]->must_stop = 1;
-
-	for (i = 0; i < skin->drivers_mem_size; ++i)
-		if (skin->drivers[i])
-			skin_driver_remove(skin->drivers[i]);
-	for (i = 0; i < skin->users_mem_size; ++i)
-		if (skin->users[i])
-			skin_driver_detach(skin->users[i]);
-	for (i = 0; i < skin->writers_mem_size; ++i)
-		if (skin->writers[i])
-			skin_service_remove(skin->writers[i]);
-	for (i = 0; i < skin->readers_mem_size; ++i)
-		if (skin->readers[i])
-			skin_service_detach(skin->readers[i]);
+	for (i = 0; i < skin->writer_count; ++i)
+	{
+		skin_internal_writer_info(skin, skin->writers[i]->info_index)->active = false;
+		skin->writers[i]->must_stop = 1;
+	}
+	for (i = 0; i < skin->reader_count; ++i)
+		skin->readers[i]->must_stop = 1;
+	for (i = 0; i < skin->reader_group_count; ++i)
+		skin->reader_groups[i]->must_stop = 1;
+
+	/*
+	 * each removal takes the object out of its list, which may move other objects of the list.  Going
+	 * backwards, the removed object is always the last one, so the objects not yet visited stay in place
+	 */
+	for (i = skin->driver_count; i > 0; --i)
+		skin_driver_remove(skin->drivers[i - 1]);
+	for (i = skin->user_count; i > 0; --i)
+		skin_driver_detach(skin->users[i - 1]);
+	for (i = skin->writer_count; i > 0; --i)
+		skin_service_remove(skin->writers[i - 1]);
+	for (i = skin->reader_count; i > 0; --i)
+		skin_service_detach(skin->readers[i - 1]);
+	for (i = skin->reader_group_count; i > 0; --i)
+		skin_reader_group_remove(skin->reader_groups[i - 1]);
 }
 URT_EXPORT_SYMBOL(skin_unload);
 
 int skin_update(struct skin *skin, const urt_task_attr *task_attr_)
 {
 	size_t i;
-	struct skin_driver_info *drivers;
 	int error = 0;
 	unsigned int updated = 0;
 	urt_task_attr task_attr;
+	struct skin_reader_group *group;
 
 	if (_sanity_check_skin(skin) || task_attr_ == NULL)
 		return EINVAL;
@@ -155,26 +174,29 @@ int skin_update(struct skin *skin, const urt_task_attr *task_attr_)
 	if (task_attr.soft)
 		task_attr.period = 0;
 
-	drivers = skin->kernel->drivers;
+	group = _load_group(skin, &task_attr);
 
 	/* go over the users and detach from the ones with inactive drivers, or the ones with a different task_attr */
-	for (i = 0; i < skin->users_mem_size; ++i)
+	for (i = 0; i < skin->user_count; ++i)
 	{
 		bool active = true, same;
 		struct skin_user *user = skin->users[i];
 
-		if (user == NULL)
-			continue;
-
-		/* check to see if reader's task attribute is different from task_attr */
-		same = user->reader->period == task_attr.period && user->reader->soft == task_attr.soft;
+		/*
+		 * check to see if reader's task attribute is different from task_attr.  If the readers are to be in
+		 * a group, the reader must already be in that group, otherwise it must not be in one and have its own task
+		 */
+		if (group || user->reader->group)
+			same = user->reader->group == group;
+		else
+			same = user->reader->period == task_attr.period && user->reader->soft == task_attr.soft;
 
 		/* check to see if driver is active (only if same, because otherwise the driver should be detached from anyway) */
 		if (same)
 		{
 			if ((error = skin_internal_driver_read_lock(&skin->kernel_locks)))
 				continue;
-			active = drivers[user->driver_index].active;
+			active = skin_internal_driver_info(skin, user->driver_index)->active;
 			skin_internal_driver_read_unlock(&skin->kernel_locks);
 		}
 
@@ -187,9 +209,9 @@ int skin_update(struct skin *skin, const urt_task_attr *task_attr_)
 		++updated;
 	}
 
-	for (i = 0; i < skin->users_mem_size; ++i)
-		if (skin->users[i] && skin->users[i]->mark_for_removal)
-			skin_driver_detach(skin->users[i]);
+	for (i = skin->user_count; i > 0; --i)
+		if (skin->users[i - 1]->mark_for_removal)
+			skin_driver_detach(skin->users[i - 1]);
 
 	/* attach to any driver not already attached to */
 	error = skin_load(skin, &task_attr);
@@ -199,17 +221,48 @@ int skin_update(struct skin *skin, const urt_task_attr *task_attr_)
 }
 URT_EXPORT_SYMBOL(skin_update);
 
+void skin_set_sensor_data_size(struct skin *skin, size_t size)
+{
+	if (_sanity_check_skin(skin))
+		return;
+
+	skin->sensor_data_size = size;
+}
+URT_EXPORT_SYMBOL(skin_set_sensor_data_size);
+
+void skin_set_contiguous_responses(struct skin *skin, bool contiguous)
+{
+	if (_sanity_check_skin(skin))
+		return;
+
+	skin->contiguous_responses = contiguous;
+}
+URT_EXPORT_SYMBOL(skin_set_contiguous_responses);
+
+void skin_set_reader_group(struct skin *skin, struct skin_reader_group *group)
+{
+	if (_sanity_check_skin(skin) || (group && group->skin != skin))
+		return;
+
+	skin->reader_group = group;
+}
+URT_EXPORT_SYMBOL(skin_set_reader_group);
+
 static void pause_resume(struct skin *skin, bool pause)
 {
 	size_t i;
 	int (*writer_pause)(struct skin_writer *) = pause?skin_writer_pause:skin_writer_resume;
 	int (*reader_pause)(struct skin_reader *) = pause?skin_reader_pause:skin_reader_resume;
+	int (*group_pause)(struct skin_reader_group *) = pause?skin_reader_group_pause:skin_reader_group_resume;
 
-	for (i = 0; i < skin->writers_mem_size; ++i)
+	for (i = 0; i < skin->writer_count; ++i)
 		writer_pause(skin->writers[i]);
 
-	for (i = 0; i < skin->readers_mem_size; ++i)
+	for (i = 0; i < skin->reader_count; ++i)
 		reader_pause(skin->readers[i]);
+
+	for (i = 0; i < skin->reader_group_count; ++i)
+		group_pause(skin->reader_groups[i]);
 }
 
 void skin_pause(struct skin *skin)
@@ -231,13 +284,11 @@ void (skin_request)(struct skin *skin, volatile sig_atomic_t *stop, ...)
 	/* note: the caller must make sure no users are added or removed in the meantime */
 
 	/* send a request to all sporadic users (nonsporadic users automatically fail) */
-	for (i = 0; i < skin->users_mem_size; ++i)
-		if (skin->users[i])
-			skin_reader_request_nonblocking(skin->users[i]->reader);
+	for (i = 0; i < skin->user_count; ++i)
+		skin_reader_request_nonblocking(skin->users[i]->reader);
 
 	/* wait for their responses */
-	for (i = 0; i < skin->users_mem_size; ++i)
-		if (skin->users[i])
-			skin_reader_await_response(skin->users[i]->reader, stop);
+	for (i = 0; i < skin->user_count; ++i)
+		skin_reader_await_response(skin->users[i]->reader, stop);
 }
 URT_EXPORT_SYMBOL(skin_request);
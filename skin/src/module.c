@@ -23,6 +23,7 @@
  */
 
 #define URT_LOG_PREFIX "skin: "
+#include <skin_sensor.h>
 #include <skin_module.h>
 #include <skin_patch.h>
 #include "user_internal.h"
@@ -32,3 +33,16 @@ struct skin_patch *skin_module_get_patch(struct skin_module *module)
 	return &module->user->patches[module->patch];
 }
 URT_EXPORT_SYMBOL(skin_module_get_patch);
+
+struct skin_response_span skin_module_get_response_span(struct skin_module *module)
+{
+	if (module == NULL || module->sensors == NULL)
+		return (struct skin_response_span){0};
+
+	return (struct skin_response_span){
+		.responses = module->user->responses + (module->sensors - module->user->sensors),
+		.count = module->sensor_count,
+		.stride = 1,
+	};
+}
+URT_EXPORT_SYMBOL(skin_module_get_response_span);
@@ -31,6 +31,18 @@ int skin_internal_name_cmp_prefix(const char *prefix1, const char *prefix2)
 	return strncmp(prefix1, prefix2, URT_NAME_LEN - 3);
 }
 
+uint32_t skin_internal_name_hash_prefix(const char *prefix)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261u;
+	size_t i;
+
+	for (i = 0; i < URT_NAME_LEN - 3 && prefix[i] != '\0'; ++i)
+		hash = (hash ^ (uint8_t)prefix[i]) * 16777619u;
+
+	return hash;
+}
+
 void skin_internal_name_cpy_prefix(char *dest, const char *src)
 {
 	strncpy(dest, src, URT_NAME_LEN - 3);
@@ -29,6 +29,8 @@
 
 /* check whether two prefixes are equal */
 int skin_internal_name_cmp_prefix(const char *prefix1, const char *prefix2);
+/* hash a prefix, looking at most at the same characters as cmp_prefix */
+uint32_t skin_internal_name_hash_prefix(const char *prefix);
 /* copy prefix over another */
 void skin_internal_name_cpy_prefix(char *dest, const char *src);
 /*
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <urt.h>
+#include "config.h"
+#include "names.h"
+#include "notify.h"
+
+#ifndef __KERNEL__
+
+#include <errno.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/*
+ * The descriptors are datagram sockets in the abstract namespace of Unix sockets, so nothing is left
+ * in the file system and the name is freed as soon as the reader's socket is closed.  Sending to a
+ * socket that doesn't exist or whose queue is full fails, which is fine; in the first case there is
+ * no one to notify, and in the second, the socket is already readable.
+ */
+static socklen_t _notify_address(struct sockaddr_un *addr, const char *prefix, unsigned int slot)
+{
+	char name[URT_NAME_LEN + 1];
+	size_t len;
+
+	skin_internal_name_set_indexed(name, prefix, "NF", slot);
+
+	*addr = (struct sockaddr_un){
+		.sun_family = AF_UNIX,
+	};
+	/* the leading '\0' of sun_path puts the name in the abstract namespace */
+	len = strlen(name);
+	memcpy(addr->sun_path + 1, "skin.", 5);
+	memcpy(addr->sun_path + 6, name, len);
+
+	return offsetof(struct sockaddr_un, sun_path) + 6 + len;
+}
+
+int skin_internal_notify_open(const char *prefix, unsigned int slot, int *error)
+{
+	struct sockaddr_un addr;
+	socklen_t addr_len = _notify_address(&addr, prefix, slot);
+	int fd;
+
+	fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		goto exit_no_socket;
+	if (bind(fd, (struct sockaddr *)&addr, addr_len))
+		goto exit_no_bind;
+
+	return fd;
+exit_no_bind:
+	*error = errno;
+	close(fd);
+	return -1;
+exit_no_socket:
+	*error = errno;
+	return -1;
+}
+
+void skin_internal_notify_close(int fd)
+{
+	if (fd >= 0)
+		close(fd);
+}
+
+void skin_internal_notify_clear(int fd)
+{
+	char buf[16];
+
+	while (recv(fd, buf, sizeof buf, MSG_DONTWAIT) >= 0)
+		;
+}
+
+int skin_internal_notify_sender(int *error)
+{
+	int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	if (fd < 0)
+		*error = errno;
+	return fd;
+}
+
+void skin_internal_notify_send(int sender, const char *prefix, unsigned int slot)
+{
+	struct sockaddr_un addr;
+	socklen_t addr_len;
+
+	if (sender < 0)
+		return;
+
+	addr_len = _notify_address(&addr, prefix, slot);
+	sendto(sender, "", 1, MSG_DONTWAIT | MSG_NOSIGNAL, (struct sockaddr *)&addr, addr_len);
+}
+
+#else
+
+int skin_internal_notify_open(const char *prefix, unsigned int slot, int *error)
+{
+	*error = ENOTSUP;
+	return -1;
+}
+
+void skin_internal_notify_close(int fd)
+{
+}
+
+void skin_internal_notify_clear(int fd)
+{
+}
+
+int skin_internal_notify_sender(int *error)
+{
+	*error = ENOTSUP;
+	return -1;
+}
+
+void skin_internal_notify_send(int sender, const char *prefix, unsigned int slot)
+{
+}
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NOTIFY_H
+#define NOTIFY_H
+
+/*
+ * utilities for notifying readers of new frames through file descriptors, so they can be
+ * waited on along with other descriptors, e.g. with poll or epoll.  A reader's descriptor is
+ * identified by the prefix of its writer and a notification slot in the writer's info.
+ *
+ * These are only available in user space.  In kernel space, open fails with ENOTSUP and the
+ * rest of the functions do nothing.
+ */
+
+/* create a descriptor that becomes readable when notified.  On error, -1 is returned */
+int skin_internal_notify_open(const char *prefix, unsigned int slot, int *error);
+/* close a descriptor created by open or sender */
+void skin_internal_notify_close(int fd);
+/* consume pending notifications of a descriptor created by open */
+void skin_internal_notify_clear(int fd);
+/* create a descriptor used to send notifications.  On error, -1 is returned */
+int skin_internal_notify_sender(int *error);
+/* notify the descriptor of the given slot.  It never blocks, and failures are ignored */
+void skin_internal_notify_send(int sender, const char *prefix, unsigned int slot);
+
+#endif
@@ -23,6 +23,7 @@
  */
 
 #define URT_LOG_PREFIX "skin: "
+#include <skin_sensor.h>
 #include <skin_patch.h>
 #include <skin_module.h>
 #include "user_internal.h"
@@ -40,3 +41,20 @@ skin_sensor_size skin_patch_sensor_count(struct skin_patch *p)
 	return res;
 }
 URT_EXPORT_SYMBOL(skin_patch_sensor_count);
+
+struct skin_response_span skin_patch_get_response_span(struct skin_patch *patch)
+{
+	skin_sensor_id first;
+
+	if (patch == NULL || patch->modules == NULL || patch->module_count == 0)
+		return (struct skin_response_span){0};
+
+	/* the sensors of the modules of a patch are consecutive */
+	first = patch->modules[0].sensors - patch->user->sensors;
+	return (struct skin_response_span){
+		.responses = patch->user->responses + first,
+		.count = skin_patch_sensor_count(patch),
+		.stride = 1,
+	};
+}
+URT_EXPORT_SYMBOL(skin_patch_get_response_span);
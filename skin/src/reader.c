@@ -27,10 +27,16 @@
 #include "internal.h"
 #include "reader_internal.h"
 #include "names.h"
+#include "notify.h"
+
+#if defined(__KERNEL__) && BITS_PER_LONG != 64
+# include <linux/math64.h>
+#endif
 
 static int _sanity_check_reader(struct skin_reader *reader, bool is_sporadic, bool writer_is_sporadic)
 {
-	return reader == NULL || reader->task == NULL || reader->skin == NULL || reader->skin->kernel == NULL
+	return reader == NULL || (reader->task == NULL && !reader->pull && reader->pool == NULL)
+		|| reader->skin == NULL || reader->skin->kernel == NULL
 		|| (is_sporadic && (reader->request == NULL || reader->response == NULL))
 		|| (writer_is_sporadic && (reader->writer_request == NULL || reader->writer_response == NULL))?-1:0;
 }
@@ -49,6 +55,312 @@ static inline bool _buffer_data_is_new(uint8_t cur_buf, urt_time cur_timestamp,
 		&& !(do_swap_prediction && urt_get_time() + swap_protection_time > writer_info->next_predicted_swap);
 }
 
+/*
+ * with a lock-free writer, copy the last written buffer in the reader's private memory and make sure the writer
+ * hasn't touched it in the meantime.  Returns true if new data has been copied.
+ */
+static bool _copy_lock_free(struct skin_reader *reader, struct skin_writer_info *writer_info,
+		uint8_t *last_buf, uint32_t *last_seq, uint64_t *retries)
+{
+	size_t size = writer_info->attr.buffer_size;
+
+	while (!reader->must_stop && writer_info->active)
+	{
+		uint8_t cur_buf;
+		uint32_t seq;
+
+		cur_buf = writer_info->last_written_buffer;
+		skin_internal_read_barrier();
+		seq = writer_info->seqs[cur_buf];
+
+		/* if the sequence is 0, the buffer has never been written to */
+		if (seq == 0)
+			return false;
+		/* if the buffer is the same as last time, there is nothing new */
+		if (cur_buf == *last_buf && seq == *last_seq)
+			return false;
+		/*
+		 * if the sequence is odd, the writer has wrapped around and is rewriting the last buffer.  Don't wait for
+		 * the writer to finish, as the writer could be of lower priority than the reader
+		 */
+		if (seq & 1)
+			return false;
+
+		skin_internal_read_barrier();
+		memcpy(reader->copy, (char *)reader->mem + cur_buf * size, size);
+		reader->frame_number = writer_info->frame_numbers[cur_buf];
+		reader->write_time = writer_info->write_times[cur_buf];
+		reader->publish_time = writer_info->publish_times[cur_buf];
+		skin_internal_read_barrier();
+
+		/* if the sequence has changed, the copy could be inconsistent, so try again */
+		if (writer_info->seqs[cur_buf] != seq)
+		{
+			++*retries;
+			continue;
+		}
+
+		*last_buf = cur_buf;
+		*last_seq = seq;
+		return true;
+	}
+
+	return false;
+}
+
+/*
+ * with a lossless reader, copy all frames written since the last read from the history ring of the writer.  Frames
+ * that the writer has overwritten before they could be copied are counted as dropped.  Returns the number of frames
+ * copied.
+ */
+static uint32_t _copy_history(struct skin_reader *reader, struct skin_writer_info *writer_info, uint64_t *dropped)
+{
+	struct skin_writer_attr_internal *attr = &writer_info->attr;
+	uint32_t copied = 0;
+
+	while (copied < attr->history && !reader->must_stop)
+	{
+		uint64_t frame_count = writer_info->frame_count;
+		uint64_t frame = reader->next_frame;
+		struct skin_history_frame *hf;
+		uint32_t seq;
+
+		skin_internal_read_barrier();
+		if (frame >= frame_count)
+			break;
+
+		/* if the writer has already wrapped around over some frames, skip them */
+		if (frame_count - frame > attr->history)
+		{
+			/* keep the frames given to the reader consecutive; the rest would be skipped next time */
+			if (copied > 0)
+				break;
+			*dropped += frame_count - attr->history - frame;
+			reader->next_frame = frame_count - attr->history;
+			continue;
+		}
+
+		hf = skin_internal_history_frame(reader->history, attr, frame);
+		seq = hf->seq;
+		skin_internal_read_barrier();
+		if ((seq & 1) == 0 && hf->frame == frame)
+		{
+			memcpy((char *)reader->copy + copied * attr->buffer_size, hf->data, attr->buffer_size);
+			skin_internal_read_barrier();
+			if (hf->seq == seq)
+			{
+				if (copied == 0)
+				{
+					reader->frame_number = frame;
+					reader->write_time = hf->write_time;
+					reader->publish_time = hf->publish_time;
+				}
+				++copied;
+				++reader->next_frame;
+				continue;
+			}
+		}
+		/*
+		 * if the frame is being overwritten, it's already lost.  Don't wait for the writer to finish, as the writer
+		 * could be of lower priority than the reader.  Keep the frames given to the reader consecutive though.
+		 */
+		if (copied > 0)
+			break;
+		++*dropped;
+		++reader->next_frame;
+	}
+
+	return copied;
+}
+
+/* add the statistics gathered outside the statistics update to the reader's statistics */
+static inline void _add_pending_statistics(struct skin_reader_statistics *stats, struct skin_reader_statistics *pending)
+{
+	stats->frames_dropped += pending->frames_dropped;
+	stats->frames_missed += pending->frames_missed;
+	stats->stale_wakeups += pending->stale_wakeups;
+	stats->lock_retries += pending->lock_retries;
+	*pending = (struct skin_reader_statistics){0};
+}
+
+/* copy the statistics to shared memory, similar to the same function in writer.c */
+static void _publish_statistics(struct skin_reader *reader, struct skin_writer_info *writer_info, urt_time exec_time)
+{
+	struct skin_reader_stats_slot *slot;
+
+	if (reader->stats_slot >= SKIN_CONFIG_MAX_READER_STATS)
+		return;
+
+	slot = &writer_info->reader_stats[reader->stats_slot];
+	skin_internal_seq_write_begin(&slot->seq);
+	slot->stats = reader->stats;
+	if (exec_time)
+		skin_histogram_record(&reader->histograms->read_times[reader->stats_slot], exec_time);
+	skin_internal_seq_write_end(&slot->seq);
+}
+
+/* whether the writer has published data newer than what the reader has last read */
+static inline bool _writer_has_new_data(struct skin_reader *reader, struct skin_writer_info *writer_info, bool lock_free,
+		uint8_t last_buf, urt_time last_timestamp, uint32_t last_seq)
+{
+	uint8_t cur_buf = writer_info->last_written_buffer;
+
+	if (reader->lossless)
+		return writer_info->frame_count > reader->next_frame;
+	if (lock_free)
+		return cur_buf != last_buf || writer_info->seqs[cur_buf] != last_seq;
+	return writer_info->write_times[cur_buf] != last_timestamp;
+}
+
+/*
+ * block until the periodic writer publishes a new frame.  The reader registers itself as a waiter before checking
+ * for new data, so that a frame published in between is not missed.  The wait is bounded so that the reader can still
+ * respond to events such as pause, stop or removal of the writer.
+ *
+ * The writer posts the semaphore once for every registration it takes, so a reader that doesn't end up being woken
+ * by the writer (because new data was already there or the wait timed out) must take back its registration.
+ * Otherwise, stale tokens would accumulate in the semaphore and make later waits return immediately.  If the writer
+ * has already taken the registrations, the token posted (or about to be posted) for it is consumed instead.  Since
+ * the registrations are not tied to a reader, it doesn't matter whose registration or token is taken back, as long as
+ * each reader takes back exactly one.
+ */
+static void _wait_new_frame(struct skin_reader *reader, struct skin_writer_info *writer_info, bool lock_free,
+		uint8_t last_buf, urt_time last_timestamp, uint32_t last_seq, urt_time timeout)
+{
+	skin_internal_atomic_inc(&writer_info->new_frame_waiters);
+	if (!_writer_has_new_data(reader, writer_info, lock_free, last_buf, last_timestamp, last_seq)
+			&& urt_sem_timed_wait(reader->writer_new_frame, timeout) == 0)
+		return;
+
+	if (!skin_internal_atomic_dec_if_positive(&writer_info->new_frame_waiters))
+		urt_sem_timed_wait(reader->writer_new_frame, SKIN_CONFIG_EVENT_MAX_DELAY);
+}
+
+/*
+ * the time the data being read has been available to the reader, measured from when the writer published it rather
+ * than when it started writing it, so the write time itself isn't included.  The writer may publish the data after the
+ * reader has noted the start of its read but before it actually takes the data, hence the clamp
+ */
+static inline urt_time _latency(struct skin_reader *reader, urt_time read_start)
+{
+	return read_start > reader->publish_time?read_start - reader->publish_time:0;
+}
+
+/* update the statistics after a read, including those gathered outside the statistics update, and publish them */
+static void _record_read(struct skin_reader *reader, struct skin_writer_info *writer_info,
+		struct skin_reader_statistics *pending, urt_time exec_time, urt_time latency)
+{
+	skin_internal_seq_write_begin(&reader->stats_seq);
+
+	++reader->stats.read_count;
+	if (exec_time > reader->stats.worst_read_time)
+		reader->stats.worst_read_time = exec_time;
+	if (exec_time < reader->stats.best_read_time || reader->stats.best_read_time == 0)
+		reader->stats.best_read_time = exec_time;
+	reader->stats.accumulated_read_time += exec_time;
+	skin_histogram_record(&reader->read_time_histogram, exec_time);
+	skin_histogram_record(&reader->latency_histogram, latency);
+	_add_pending_statistics(&reader->stats, pending);
+
+	skin_internal_seq_write_end(&reader->stats_seq);
+	_publish_statistics(reader, writer_info, exec_time);
+}
+
+/* when nothing is read, the statistics still need to be updated with stale wakeups and such */
+static void _record_no_read(struct skin_reader *reader, struct skin_writer_info *writer_info,
+		struct skin_reader_statistics *pending)
+{
+	skin_internal_seq_write_begin(&reader->stats_seq);
+	_add_pending_statistics(&reader->stats, pending);
+	skin_internal_seq_write_end(&reader->stats_seq);
+	_publish_statistics(reader, writer_info, 0);
+}
+
+/* state of a phase-locked reader, kept in the task */
+struct phase_lock
+{
+	urt_time next_wakeup;			/* absolute time of the next wakeup */
+	urt_time jitter;			/* filtered deviation of the publish instants from the expected phase */
+};
+
+/* divide non-negative times, also giving the remainder */
+static inline urt_time _time_div(urt_time t, urt_time d, urt_time *rem)
+{
+#if !defined(__KERNEL__) || BITS_PER_LONG == 64
+	*rem = t % d;
+	return t / d;
+#else
+	/*
+	 * in kernel space, for 32 bit architectures, 64 bit division is done with div64_u64_rem.  do_div is not used
+	 * since it only takes 32 bit divisors, and periods could be longer than 2^32 nanoseconds
+	 */
+	uint64_t r;
+	uint64_t q = div64_u64_rem(t, d, &r);
+
+	*rem = r;
+	return q;
+#endif
+}
+
+/*
+ * a phase-locked reader wakes up shortly after the writer publishes a frame, instead of at whatever phase its task
+ * happened to start with, which could make the data up to one writer period older than necessary.  Each period, the
+ * phase of the next wakeup with respect to the last publish instant of the writer (plus a margin that covers the
+ * jitter of those instants) is measured.  While the error is large, i.e. at startup, it is corrected at once.  Once
+ * locked, only a fraction of it is corrected, so that the reader follows the drift between the clocks of the writer
+ * and the reader without inheriting the jitter of the writer.
+ */
+static void _wait_phase_locked(struct skin_reader *reader, struct skin_writer_info *writer_info, struct phase_lock *pl)
+{
+	urt_time writer_period = writer_info->period;
+	urt_time last_publish;
+	urt_time margin, offset, phase, error, now;
+	uint32_t seq;
+
+	/* the publish time is 64 bits, which could be torn on 32 bit architectures if not read under its sequence */
+	do
+	{
+		seq = skin_internal_seq_read_begin(&writer_info->publish_seq);
+		last_publish = writer_info->last_publish_time;
+	} while (skin_internal_seq_read_retry(&writer_info->publish_seq, seq));
+
+	pl->next_wakeup += reader->period;
+
+	if (last_publish != 0 && writer_period > 0)
+	{
+		margin = 2 * pl->jitter;
+		if (margin < writer_period / 32)
+			margin = writer_period / 32;
+		if (margin > writer_period / 4)
+			margin = writer_period / 4;
+
+		/* error of the next wakeup with respect to the closest publish instant plus margin */
+		offset = pl->next_wakeup - last_publish - margin;
+		if (offset >= 0)
+			_time_div(offset, writer_period, &phase);
+		else
+		{
+			_time_div(-offset, writer_period, &phase);
+			phase = phase == 0?0:writer_period - phase;
+		}
+		error = phase > writer_period / 2?phase - writer_period:phase;
+
+		if (error > writer_period / 8 || error < -writer_period / 8)
+			pl->next_wakeup -= error;
+		else
+		{
+			pl->next_wakeup -= error / 4;
+			pl->jitter += ((error < 0?-error:error) - pl->jitter) / 8;
+		}
+	}
+
+	/* if the reader has overrun, skip the missed periods rather than reading in a burst */
+	now = urt_get_time();
+	if (pl->next_wakeup <= now)
+		pl->next_wakeup += (_time_div(now - pl->next_wakeup, reader->period, &offset) + 1) * reader->period;
+	urt_sleep(pl->next_wakeup - now);
+}
+
 /*
  * the synchronization mechanism in the reader with the writer is as follows:
  *
@@ -63,12 +375,12 @@ static inline bool _buffer_data_is_new(uint8_t cur_buf, urt_time cur_timestamp,
  *			if new					if new			if new
  *									break
  *								unlock
- *								sleep
+ *								wait new frame
  *							}
  *				func			func					func
  *			unlock				unlock				unlock
  *							respond
- *			wait period			sleep				sleep
+ *			wait period							wait new frame
  *		}				}				}
  *
  * Sporadic	S4. loop {			S5. loop {			S6. loop {
@@ -79,7 +391,7 @@ static inline bool _buffer_data_is_new(uint8_t cur_buf, urt_time cur_timestamp,
  *			func				func				func
  *			unlock				unlock				unlock
  *							respond
- *			wait period			sleep				sleep
+ *			wait period							sleep
  *		}				}				}
  *
  * Multi Buffer:
@@ -96,7 +408,7 @@ static inline bool _buffer_data_is_new(uint8_t cur_buf, urt_time cur_timestamp,
  *			func				func				func
  *			unlock(b)			unlock(b)			unlock(b)
  *							respond
- *			wait period			sleep				sleep
+ *			wait period							wait new frame
  *		}				}				}
  *
  * Sporadic	M4. loop {			M5. loop {			M6. loop {
@@ -107,13 +419,76 @@ static inline bool _buffer_data_is_new(uint8_t cur_buf, urt_time cur_timestamp,
  *			func				func				func
  *			unlock(cur)			unlock(cur)			unlock(cur)
  *							respond
- *			wait period			sleep				sleep
+ *			wait period							sleep
  *		}				}				}
  *
+ * Lock-free:
+ *
+ *		Periodic Reader			Sporadic Reader			Soft Reader
+ *
+ * Periodic	L1. loop {			L2. loop {			L3. loop {
+ * Writer						wait request
+ *							loop {
+ *			copy(last)				copy(last)		copy(last)
+ *								if new
+ *									break
+ *								wait new frame
+ *							}
+ *			if new				func				if new
+ *				func						func
+ *							respond
+ *			wait period							wait new frame
+ *		}				}				}
+ *
+ * Sporadic	L4. loop {			L5. loop {			L6. loop {
+ * Writer						wait request
+ *			send writer request		send writer request		send writer_request
+ *			wait writer response		wait writer response		wait_writer_response
+ *			copy(last)			copy(last)			copy(last)
+ *			func				func				func
+ *							respond
+ *			wait period							sleep
+ *		}				}				}
+ *
+ * History (lossless readers, regardless of the number of buffers of the writer or whether it is lock-free):
+ *
+ *		Periodic Reader			Sporadic Reader			Soft Reader
+ *
+ * Periodic	H1. loop {			H2. loop {			H3. loop {
+ * Writer						wait request
+ *							loop {
+ *			copy(since last)			copy(since last)	copy(since last)
+ *								if any
+ *									break
+ *								wait new frame
+ *							}
+ *			if any				func				if any
+ *				func						func
+ *							respond
+ *			wait period							wait new frame
+ *		}				}				}
+ *
+ * Sporadic	H4. loop {			H5. loop {			H6. loop {
+ * Writer						wait request
+ *			send writer request		send writer request		send writer_request
+ *			wait writer response		wait writer response		wait_writer_response
+ *			copy(since last)		copy(since last)		copy(since last)
+ *			func				func				func
+ *							respond
+ *			wait period							sleep
+ *		}				}				}
+ *
+ * where copy(since last) copies every frame from the writer's history ring that the reader hasn't yet seen, and func
+ * is called once with all of them.  Frames already overwritten in the ring are counted as dropped.
+ *
+ * In the other cases, copy(last) retries until it can take a copy of the last buffer without the writer touching it in the meantime,
+ * and wait new frame blocks until the periodic writer signals that it has published new data (or until
+ * SKIN_CONFIG_EVENT_MAX_DELAY passes, so that events such as pause and stop are still noticed).
+ *
  * Note: the combination of sporadic writer and soft reader could be deadly!  The combination of single buffer
  * and soft reader would not be very wise either.
  *
- * In the function, the specific code that belongs to either of these 12 cases is marked as such.
+ * In the function, the specific code that belongs to either of these 24 cases is marked as such.
  */
 void skin_reader_acquisition_task(urt_task *task, void *data)
 {
@@ -122,17 +497,29 @@ void skin_reader_acquisition_task(urt_task *task, void *data)
 	urt_time swap_protection_time = 0;
 	uint8_t last_buffer = 0;
 	urt_time last_timestamp = 0;
+	uint32_t last_seq = 0;
+	uint64_t last_frame = 0;
+	bool has_last_frame = false;
+	struct skin_reader_statistics pending = {0};
+	struct phase_lock phase_lock = {0};
 	bool multi_buffer;
+	bool lock_free;
+	bool lossless;
 	bool sporadic;
 	bool soft;
 	bool writer_periodic;
 
 	if (_sanity_check_reader(reader, false, false))
 		goto exit_bad_argument;
-	writer_info = &reader->skin->kernel->writers[reader->writer_index];
+	writer_info = skin_internal_writer_info(reader->skin, reader->writer_index);
 
+	skin_internal_seq_write_begin(&reader->stats_seq);
 	reader->stats.start_time = urt_get_time();
-	multi_buffer = writer_info->attr.buffer_count > 1;
+	skin_internal_seq_write_end(&reader->stats_seq);
+	_publish_statistics(reader, writer_info, 0);
+	lossless = reader->lossless;
+	lock_free = writer_info->attr.lock_free && !lossless;
+	multi_buffer = writer_info->attr.buffer_count > 1 && !writer_info->attr.lock_free && !lossless;
 	writer_periodic = writer_info->period > 0;
 	soft = reader->soft;
 	sporadic = reader->period <= 0 && !soft;
@@ -143,27 +530,33 @@ void skin_reader_acquisition_task(urt_task *task, void *data)
 
 	urt_dbg(reader->skin->log_file, "reader corresponding to writer %u started (period: %lld, soft: %s) (name: %s)\n",
 			reader->writer_index, reader->period, reader->soft?"Yes":"No",
-			reader->skin->kernel->writers[reader->writer_index].attr.prefix);
+			skin_internal_writer_info(reader->skin, reader->writer_index)->attr.prefix);
 
+	phase_lock.next_wakeup = urt_get_time();
 	while (!reader->must_stop)
 	{
 		urt_time exec_time = urt_get_exec_time(), passed_time;
 		uint8_t current_buffer = 0;
 		bool must_pause;
-		bool locked;
+		bool has_read = false;
+		uint32_t frames = 1;
+		urt_time latency;
 
-		/* if paused or writer is paused, sleep and retry */
+		/* if paused or writer is paused, sleep and retry.  Frames written while paused are not considered missed */
 		must_pause = reader->must_pause || writer_info->paused || !writer_info->active;
 		reader->paused = must_pause;
 		if (must_pause)
+		{
+			has_last_frame = false;
 			goto skip_read;
+		}
 
-		/* cases S2, S5, M2 and M5: wait for request for sporadic reads */
+		/* cases S2, S5, M2, M5, L2 and L5: wait for request for sporadic reads */
 		if (sporadic)
 			if (urt_sem_wait(reader->request, &reader->must_stop))
 				goto skip_read;
 
-		/* cases S4-6 and M4-6: send request and await response for sporadic writers */
+		/* cases S4-6, M4-6 and L4-6: send request and await response for sporadic writers */
 		if (!writer_periodic)
 		{
 			if (urt_sem_post(reader->writer_request))
@@ -172,6 +565,51 @@ void skin_reader_acquisition_task(urt_task *task, void *data)
 				goto skip_read_respond_users;
 		}
 
+		/* cases H1-6: take a copy of all frames since last read, and in case H2 keep trying until there is a new frame */
+		if (lossless)
+		{
+			while ((frames = _copy_history(reader, writer_info, &pending.frames_dropped)) == 0
+					&& writer_periodic && sporadic && !reader->must_stop && writer_info->active)
+				_wait_new_frame(reader, writer_info, false, 0, 0, 0, SKIN_CONFIG_EVENT_MAX_DELAY);
+
+			if (frames == 0)
+			{
+				++pending.stale_wakeups;
+				goto skip_read_respond_users;
+			}
+
+			passed_time = urt_get_time();
+
+			/* call the reader callback with the private copy of the frames, one after the other */
+			reader->callbacks.read(reader, reader->copy, frames * writer_info->attr.buffer_size,
+					reader->callbacks.user_data);
+
+			goto read_done;
+		}
+
+		/* cases L1-6: take a copy of the last buffer, and in case L2 keep trying until there is new data */
+		if (lock_free)
+		{
+			bool is_new;
+
+			while (!(is_new = _copy_lock_free(reader, writer_info, &last_buffer, &last_seq, &pending.lock_retries))
+					&& writer_periodic && sporadic && !reader->must_stop && writer_info->active)
+				_wait_new_frame(reader, writer_info, true, last_buffer, 0, last_seq, SKIN_CONFIG_EVENT_MAX_DELAY);
+
+			if (!is_new)
+			{
+				++pending.stale_wakeups;
+				goto skip_read_respond_users;
+			}
+
+			passed_time = urt_get_time();
+
+			/* call the reader callback with the private copy of the buffer */
+			reader->callbacks.read(reader, reader->copy, writer_info->attr.buffer_size, reader->callbacks.user_data);
+
+			goto read_done;
+		}
+
 		/* this loop is for retry of synchronization with multi-buffer writers */
 		while (1)
 		{
@@ -211,7 +649,7 @@ void skin_reader_acquisition_task(urt_task *task, void *data)
 					if (_buffer_data_is_new(0, writer_info->write_times[0], 0, last_timestamp, reader, writer_info, false, 0))
 						break;
 					urt_rwlock_read_unlock(reader->rwls[0]);
-					urt_sleep(SKIN_CONFIG_EVENT_MAX_DELAY);
+					_wait_new_frame(reader, writer_info, false, 0, last_timestamp, 0, SKIN_CONFIG_EVENT_MAX_DELAY);
 				}
 			}
 			/* cases S1, S3-6: wait until the buffer becomes available */
@@ -224,7 +662,10 @@ void skin_reader_acquisition_task(urt_task *task, void *data)
 			/* cases M1-6: try lock the buffer.  If it fails, a buffer swap has happened in the meantime, so try again */
 			else
 				if (urt_rwlock_try_read_lock(reader->rwls[current_buffer]))
+				{
+					++pending.lock_retries;
 					continue;
+				}
 
 			/* except the sole case where a buffer swap has happened during calculation, the lock should be acquired now */
 			break;
@@ -234,6 +675,7 @@ void skin_reader_acquisition_task(urt_task *task, void *data)
 		if (!multi_buffer && !_buffer_data_is_new(0, writer_info->write_times[0], 0, last_timestamp, reader, writer_info, false, 0))
 		{
 			urt_rwlock_read_unlock(reader->rwls[0]);
+			++pending.stale_wakeups;
 			goto skip_read_respond_users;
 		}
 
@@ -249,6 +691,9 @@ void skin_reader_acquisition_task(urt_task *task, void *data)
 		/* call the reader callback with the current buffer */
 		last_timestamp = writer_info->write_times[current_buffer];
 		last_buffer = current_buffer;
+		reader->frame_number = writer_info->frame_numbers[current_buffer];
+		reader->write_time = last_timestamp;
+		reader->publish_time = writer_info->publish_times[current_buffer];
 		reader->callbacks.read(reader,
 				(char *)reader->mem + current_buffer * writer_info->attr.buffer_size,
 				writer_info->attr.buffer_size,
@@ -257,41 +702,65 @@ void skin_reader_acquisition_task(urt_task *task, void *data)
 		/* unlock the buffer */
 		urt_rwlock_read_unlock(reader->rwls[current_buffer]);
 
+read_done:
+		has_read = true;
+
+		/*
+		 * count the frames written since the last read that the reader has never seen.  A lossless reader only
+		 * misses frames that are overwritten in history, which are already counted as dropped
+		 */
+		if (!lossless && has_last_frame && reader->frame_number > last_frame + 1)
+			pending.frames_missed += reader->frame_number - last_frame - 1;
+		last_frame = reader->frame_number + frames - 1;
+		has_last_frame = true;
+
+		/* the latency is the time the data has been available at the time the read started */
+		latency = _latency(reader, passed_time);
+
 		/* update swap skip protection time to converge to passed time with a factor of 1/8 */
 		passed_time = urt_get_time() - passed_time;
 		swap_protection_time = (swap_protection_time * 7 + passed_time) / 8;
 
-		/* statistics */
-		locked = urt_mutex_lock(reader->stats_lock, &reader->must_stop) == 0;
+		/* cases M1-M6: let the writer know how long buffers are held, so it can better budget its swaps */
+		if (multi_buffer && passed_time > writer_info->reader_hold_time)
+			writer_info->reader_hold_time = passed_time;
 
-		++reader->stats.read_count;
+		/* statistics */
 		exec_time = urt_get_exec_time() - exec_time;
 		/* some subsystems such as RTAI lack enough precision for execution time */
 		/* Note: RTAI at https://github.com/ShabbyX/RTAI/commits/master has fixed this error */
 		if (exec_time == 0)
 			exec_time = passed_time;
-		if (exec_time > reader->stats.worst_read_time)
-			reader->stats.worst_read_time = exec_time;
-		if (exec_time < reader->stats.best_read_time || reader->stats.best_read_time == 0)
-			reader->stats.best_read_time = exec_time;
-		reader->stats.accumulated_read_time += exec_time;
-
-		if (locked)
-			urt_mutex_unlock(reader->stats_lock);
+		_record_read(reader, writer_info, &pending, exec_time, latency);
 
 skip_read_respond_users:
-		/* cases S2, S5, M2 and M5: if sporadic, signal your requesters that read has been done */
+		/* if nothing was read, the statistics are not yet updated with stale wakeups and such */
+		if (!has_read)
+			_record_no_read(reader, writer_info, &pending);
+
+		/* cases S2, S5, M2, M5, L2 and L5: if sporadic, signal your requesters that read has been done */
 		if (sporadic)
 			skin_internal_signal_all_requests(reader->request, reader->response);
 skip_read:
-		/* cases S1, S4, M1 and M4: if periodic, wait your period */
-		if (!sporadic && !soft)
+		/*
+		 * cases S1, S4, M1, M4, L1 and L4: if periodic, wait your period.  In cases S1, M1, L1 and H1, if
+		 * phase-locked, the reader times its own wakeups, aligned with the writer's
+		 */
+		if (!sporadic && !soft && reader->phase_locked)
+			_wait_phase_locked(reader, writer_info, &phase_lock);
+		else if (!sporadic && !soft)
 			urt_task_wait_period(task);
 		/*
-		 * cases S3, S6, M3 and M6: if soft, sleep a little to avoid busy waiting (if single buffer),
-		 * crazily invoking writer (if sporadic writer) or a race condition where a reader requests
-		 * so fast while the writer is responding, and the same reader wakes up a second time instead
-		 * of another reader who had been waiting before.
+		 * cases S3, M3 and L3: if soft and the writer is periodic, block until the writer publishes a new frame.
+		 * If paused, sleep instead, since the writer could be publishing frames that are not going to be read.
+		 */
+		else if (soft && writer_periodic && !must_pause)
+			_wait_new_frame(reader, writer_info, lock_free, last_buffer, last_timestamp, last_seq,
+					SKIN_CONFIG_EVENT_MAX_DELAY);
+		/*
+		 * cases S6, M6 and L6: if soft and the writer is sporadic, sleep a little to avoid crazily invoking writer or a
+		 * race condition where a reader requests so fast while the writer is responding, and the same reader wakes up
+		 * a second time instead of another reader who had been waiting before.
 		 *
 		 * While this doesn't theoretically solve the race condition, it is ok because first of all,
 		 * with the added sleep, that race condition would happen if the system is very heavily loaded.
@@ -305,11 +774,11 @@ skip_read:
 		 * This is a valid assumption since in a system, soft real-time threads should have smaller
 		 * priority with respect to hard real-time threads.
 		 *
-		 * cases S2, S5, M2, M5: if sporadic, sleep is unnecessary.  However, in the unlikely event
-		 * that a lock failed to acquire, this sleep would prevent retrying immediately, effectively
-		 * preventing a busy loop.
+		 * cases S2, S5, M2, M5, L2, L5: if sporadic, waiting for request already blocks, so sleep is unnecessary.
+		 * However, if paused or in the unlikely event that a lock failed to acquire, this sleep would prevent retrying
+		 * immediately, effectively preventing a busy loop.
 		 */
-		else /* soft || sporadic */
+		else if (soft || !has_read)
 			urt_sleep(SKIN_CONFIG_EVENT_MAX_DELAY);
 	}
 
@@ -416,7 +885,10 @@ int skin_reader_get_attr(struct skin_reader *reader, struct skin_reader_attr *at
 	 * all readers are detached, so this pointer will remain live until at least after this reader
 	 * is destroyed.  This behavior is documented.
 	 */
-	attr->name = reader->skin->kernel->writers[reader->writer_index].attr.prefix;
+	attr->name = skin_internal_writer_info(reader->skin, reader->writer_index)->attr.prefix;
+	attr->lossless = reader->lossless;
+	attr->pull = reader->pull;
+	attr->phase_locked = reader->phase_locked;
 
 	skin_internal_global_read_unlock(&reader->skin->kernel_locks);
 
@@ -426,25 +898,367 @@ URT_EXPORT_SYMBOL(skin_reader_get_attr);
 
 int skin_reader_get_statistics(struct skin_reader *reader, struct skin_reader_statistics *stats)
 {
-	bool locked = false;
+	uint32_t seq;
 
 	if (_sanity_check_reader(reader, false, false) || stats == NULL)
 		return EINVAL;
 
+	/* the reader task never waits for this copy, so take it again if the task has updated the statistics meanwhile */
+	do
+	{
+		seq = skin_internal_seq_read_begin(&reader->stats_seq);
+		*stats = reader->stats;
+	} while (skin_internal_seq_read_retry(&reader->stats_seq, seq));
+
+	return 0;
+}
+URT_EXPORT_SYMBOL(skin_reader_get_statistics);
+
+int skin_reader_get_histogram(struct skin_reader *reader, int type, struct skin_histogram *hist)
+{
+	uint32_t seq;
+
+	if (_sanity_check_reader(reader, false, false) || hist == NULL)
+		return EINVAL;
+	if (type != SKIN_READER_HISTOGRAM_READ_TIME && type != SKIN_READER_HISTOGRAM_LATENCY)
+		return EINVAL;
+
+	do
+	{
+		seq = skin_internal_seq_read_begin(&reader->stats_seq);
+		*hist = type == SKIN_READER_HISTOGRAM_READ_TIME?reader->read_time_histogram:reader->latency_histogram;
+	} while (skin_internal_seq_read_retry(&reader->stats_seq, seq));
+
+	return 0;
+}
+URT_EXPORT_SYMBOL(skin_reader_get_histogram);
+
+uint64_t skin_reader_get_frame_number(struct skin_reader *reader)
+{
+	if (_sanity_check_reader(reader, false, false))
+		return 0;
+
+	return reader->frame_number;
+}
+URT_EXPORT_SYMBOL(skin_reader_get_frame_number);
+
+/*
+ * check whether a pull reader can read from the writer.  Similar to the task, if the reader or the writer is paused,
+ * frames written in the meantime are not considered missed
+ */
+static int _pull_check_state(struct skin_reader *reader, struct skin_writer_info *writer_info)
+{
+	if (!writer_info->active)
+		return ENOENT;
+
+	reader->paused = reader->must_pause || writer_info->paused;
+	if (reader->paused)
+	{
+		reader->pull_state.has_last_frame = false;
+		return EAGAIN;
+	}
+
+	return 0;
+}
+
+/* time left until the deadline of a pull read, or 0 if it has passed */
+static inline urt_time _remaining_time(urt_time deadline)
+{
+	urt_time now = urt_get_time();
+
+	return deadline > now?deadline - now:0;
+}
+
+/*
+ * a pull read goes through the same cases as the task of a soft reader (cases S3, S6, M3, M6, L3, L6, H3 and H6 above),
+ * except that it never waits for new data; that is left to skin_reader_wait_new.  With multiple buffers, a buffer swap
+ * during the read is detected by the failure to lock the last written buffer, in which case the reader waits for the
+ * writer to release it.
+ *
+ * Soft readers serviced by the soft reader pool are read the same way, by the workers of the pool.
+ */
+int skin_internal_reader_read_latest(struct skin_reader *reader, urt_time timeout)
+{
+	struct skin_writer_info *writer_info;
+	struct skin_reader_statistics pending = {0};
+	urt_time exec_time = urt_get_exec_time(), passed_time, latency, deadline;
+	uint8_t current_buffer = 0;
+	uint32_t frames = 1;
+	bool multi_buffer;
+	bool lock_free;
+	int err;
+
+	writer_info = skin_internal_writer_info(reader->skin, reader->writer_index);
+	deadline = urt_get_time() + timeout;
+
+	if ((err = _pull_check_state(reader, writer_info)))
+		return err;
+
+	lock_free = writer_info->attr.lock_free && !reader->lossless;
+	multi_buffer = writer_info->attr.buffer_count > 1 && !writer_info->attr.lock_free && !reader->lossless;
+
+	/*
+	 * cases S6, M6, L6 and H6: send request and await response for sporadic writers.  If a previous request timed
+	 * out, its response is consumed if already given, so it wouldn't be mistaken for the response to this request.
+	 * Otherwise, the writer is yet to respond to it, so the response is awaited without sending another request
+	 */
+	if (writer_info->period == 0)
+	{
+		if (reader->pull_state.request_pending && urt_sem_try_wait(reader->writer_response) == 0)
+			reader->pull_state.request_pending = false;
+		if (!reader->pull_state.request_pending)
+		{
+			if (urt_sem_post(reader->writer_request))
+				return EAGAIN;
+			reader->pull_state.request_pending = true;
+		}
+		if (urt_sem_timed_wait(reader->writer_response, _remaining_time(deadline)))
+			return ETIMEDOUT;
+		reader->pull_state.request_pending = false;
+	}
+
+	/* cases H3 and H6: take a copy of all frames since last read */
+	if (reader->lossless)
+	{
+		frames = _copy_history(reader, writer_info, &pending.frames_dropped);
+		if (frames == 0)
+			goto exit_no_data;
+
+		passed_time = urt_get_time();
+		reader->callbacks.read(reader, reader->copy, frames * writer_info->attr.buffer_size,
+				reader->callbacks.user_data);
+
+		goto read_done;
+	}
+
+	/* cases L3 and L6: take a copy of the last buffer */
+	if (lock_free)
+	{
+		if (!_copy_lock_free(reader, writer_info, &reader->pull_state.last_buffer, &reader->pull_state.last_seq,
+					&pending.lock_retries))
+			goto exit_no_data;
+
+		passed_time = urt_get_time();
+		reader->callbacks.read(reader, reader->copy, writer_info->attr.buffer_size, reader->callbacks.user_data);
+
+		goto read_done;
+	}
+
+	if (multi_buffer)
+	{
+		/*
+		 * cases M3 and M6: lock the last written buffer if it has new data.  If locking fails, a swap has happened
+		 * and the writer is rewriting the buffer, in which case the last written buffer is normally already a newer
+		 * one, so retry with that.  Only if the writer has locked the buffer but not yet published the previous one,
+		 * i.e. the same buffer is still the last written, wait for the writer to release it rather than spinning.
+		 * Either way, retries are bounded by the deadline
+		 */
+		while (true)
+		{
+			urt_time remaining;
+
+			current_buffer = writer_info->last_written_buffer;
+			if (!_buffer_data_is_new(current_buffer, writer_info->write_times[current_buffer],
+						reader->pull_state.last_buffer, reader->pull_state.last_timestamp,
+						reader, writer_info, false, 0))
+				goto exit_no_data;
+			if (urt_rwlock_try_read_lock(reader->rwls[current_buffer]) == 0)
+				break;
+
+			++pending.lock_retries;
+			remaining = _remaining_time(deadline);
+			if (remaining == 0)
+			{
+				err = ETIMEDOUT;
+				goto exit_no_lock;
+			}
+			if (writer_info->last_written_buffer != current_buffer)
+				continue;
+			if (urt_rwlock_timed_read_lock(reader->rwls[current_buffer], remaining))
+				continue;
+			if (_buffer_data_is_new(current_buffer, writer_info->write_times[current_buffer],
+						reader->pull_state.last_buffer, reader->pull_state.last_timestamp,
+						reader, writer_info, false, 0))
+				break;
+			urt_rwlock_read_unlock(reader->rwls[current_buffer]);
+		}
+	}
+	else
+	{
+		/* cases S3 and S6: wait until the buffer becomes available, and skip it if there is nothing new to read */
+		if (urt_rwlock_timed_read_lock(reader->rwls[0], _remaining_time(deadline)))
+		{
+			err = ETIMEDOUT;
+			goto exit_no_lock;
+		}
+		if (!_buffer_data_is_new(0, writer_info->write_times[0], 0, reader->pull_state.last_timestamp,
+					reader, writer_info, false, 0))
+		{
+			urt_rwlock_read_unlock(reader->rwls[0]);
+			goto exit_no_data;
+		}
+	}
+
+	/* if unlocked because the writer is removed, the buffer is unlocked, but there would be no new data */
+	if (!writer_info->active)
+	{
+		urt_rwlock_read_unlock(reader->rwls[current_buffer]);
+		err = ENOENT;
+		goto exit_no_lock;
+	}
+
+	passed_time = urt_get_time();
+
+	/* call the reader callback with the current buffer */
+	reader->pull_state.last_timestamp = writer_info->write_times[current_buffer];
+	reader->pull_state.last_buffer = current_buffer;
+	reader->frame_number = writer_info->frame_numbers[current_buffer];
+	reader->write_time = reader->pull_state.last_timestamp;
+	reader->publish_time = writer_info->publish_times[current_buffer];
+	reader->callbacks.read(reader,
+			(char *)reader->mem + current_buffer * writer_info->attr.buffer_size,
+			writer_info->attr.buffer_size,
+			reader->callbacks.user_data);
+
+	urt_rwlock_read_unlock(reader->rwls[current_buffer]);
+
+read_done:
+	/* count the frames written since the last read that the reader has never seen, unless already counted as dropped */
+	if (!reader->lossless && reader->pull_state.has_last_frame && reader->frame_number > reader->pull_state.last_frame + 1)
+		pending.frames_missed += reader->frame_number - reader->pull_state.last_frame - 1;
+	reader->pull_state.last_frame = reader->frame_number + frames - 1;
+	reader->pull_state.has_last_frame = true;
+
+	latency = _latency(reader, passed_time);
+
+	/* cases M3 and M6: let the writer know how long buffers are held, so it can better budget its swaps */
+	passed_time = urt_get_time() - passed_time;
+	if (multi_buffer && passed_time > writer_info->reader_hold_time)
+		writer_info->reader_hold_time = passed_time;
+
+	exec_time = urt_get_exec_time() - exec_time;
+	if (exec_time == 0)
+		exec_time = passed_time;
+	_record_read(reader, writer_info, &pending, exec_time, latency);
+
+	return 0;
+exit_no_data:
+	err = EAGAIN;
+exit_no_lock:
+	_record_no_read(reader, writer_info, &pending);
+	return err;
+}
+
+int skin_reader_read_latest(struct skin_reader *reader, urt_time timeout)
+{
+	if (_sanity_check_reader(reader, false, false) || !reader->pull)
+		return EINVAL;
+	return skin_internal_reader_read_latest(reader, timeout);
+}
+URT_EXPORT_SYMBOL(skin_reader_read_latest);
+
+int skin_reader_wait_new(struct skin_reader *reader, urt_time timeout)
+{
+	struct skin_writer_info *writer_info;
+	urt_time deadline;
+	bool lock_free;
+
+	if (_sanity_check_reader(reader, false, false) || !reader->pull)
+		return EINVAL;
+	writer_info = skin_internal_writer_info(reader->skin, reader->writer_index);
+	deadline = urt_get_time() + timeout;
+	lock_free = writer_info->attr.lock_free && !reader->lossless;
+
+	while (writer_info->active)
+	{
+		urt_time now;
+
+		/* a sporadic writer writes on request, which skin_reader_read_latest does */
+		if (writer_info->period == 0)
+			return 0;
+
+		if (_writer_has_new_data(reader, writer_info, lock_free, reader->pull_state.last_buffer,
+					reader->pull_state.last_timestamp, reader->pull_state.last_seq))
+			return 0;
+
+		now = urt_get_time();
+		if (now >= deadline)
+			return ETIMEDOUT;
+
+		/* wake up at least every SKIN_CONFIG_EVENT_MAX_DELAY to notice removal of the writer */
+		_wait_new_frame(reader, writer_info, lock_free, reader->pull_state.last_buffer,
+				reader->pull_state.last_timestamp, reader->pull_state.last_seq,
+				deadline - now < SKIN_CONFIG_EVENT_MAX_DELAY?deadline - now:SKIN_CONFIG_EVENT_MAX_DELAY);
+	}
+
+	return ENOENT;
+}
+URT_EXPORT_SYMBOL(skin_reader_wait_new);
+
+int (skin_reader_get_notify_fd)(struct skin_reader *reader, int *error, ...)
+{
+	struct skin_writer_info *writer_info;
+	uint16_t s;
+	int fd;
+	int err;
+
+	if (_sanity_check_reader(reader, false, false))
+		goto exit_bad_param;
+
+	/* the descriptor is created on first request */
+	if (reader->notify_fd >= 0)
+		return reader->notify_fd;
+
 	/*
-	 * if calling from real-time context, locking is possible.  Otherwise,
-	 * even if task is running, synchronization is impossible.  However,
-	 * if not in real-time context, it is likely that this function is being
-	 * called from cleanup hook.
+	 * take a notification slot of the writer and create the descriptor under the global lock, so concurrent first
+	 * requests wouldn't each create one
 	 */
-	if (urt_is_rt_context())
-		locked = urt_mutex_lock(reader->stats_lock, &reader->must_stop) == 0;
+	if ((err = skin_internal_global_write_lock(&reader->skin->kernel_locks)))
+		goto exit_fail;
 
-	*stats = reader->stats;
+	/* another thread may have created the descriptor in the meantime */
+	if (reader->notify_fd >= 0)
+		goto exit_created;
 
-	if (locked)
-		urt_mutex_unlock(reader->stats_lock);
+	writer_info = skin_internal_writer_info(reader->skin, reader->writer_index);
+	for (s = 0; s < SKIN_CONFIG_MAX_READER_NOTIFIERS; ++s)
+		if (!writer_info->reader_notifiers[s])
+			break;
+	if (s >= SKIN_CONFIG_MAX_READER_NOTIFIERS)
+		goto exit_no_slot;
+
+	fd = skin_internal_notify_open(writer_info->attr.prefix, s, &err);
+	if (fd < 0)
+		goto exit_no_fd;
+
+	writer_info->reader_notifiers[s] = true;
+	++writer_info->reader_notifier_count;
+	reader->notify_slot = s;
+	reader->notify_fd = fd;
+exit_created:
+	skin_internal_global_write_unlock(&reader->skin->kernel_locks);
+
+	return reader->notify_fd;
+exit_no_slot:
+	err = ENOSPC;
+exit_no_fd:
+	skin_internal_global_write_unlock(&reader->skin->kernel_locks);
+exit_fail:
+	if (error)
+		*error = err;
+	return -1;
+exit_bad_param:
+	err = EINVAL;
+	goto exit_fail;
+}
+URT_EXPORT_SYMBOL(skin_reader_get_notify_fd);
 
+int skin_reader_clear_notification(struct skin_reader *reader)
+{
+	if (_sanity_check_reader(reader, false, false) || reader->notify_fd < 0)
+		return EINVAL;
+
+	skin_internal_notify_clear(reader->notify_fd);
 	return 0;
 }
-URT_EXPORT_SYMBOL(skin_reader_get_statistics);
+URT_EXPORT_SYMBOL(skin_reader_clear_notification);
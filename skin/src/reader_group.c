@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define URT_LOG_PREFIX "skin: "
+#include <skin_base.h>
+#include "internal.h"
+#include "reader_internal.h"
+#include "reader_group_internal.h"
+
+static int _sanity_check_skin(struct skin *skin)
+{
+	return skin == NULL || skin->kernel == NULL?-1:0;
+}
+
+static int _sanity_check_group(struct skin_reader_group *group)
+{
+	return group == NULL || group->task == NULL || group->lock == NULL || group->skin == NULL?-1:0;
+}
+
+static void _reader_group_task(urt_task *task, void *data)
+{
+	struct skin_reader_group *group = data;
+
+	urt_dbg(group->skin->log_file, "reader group started (period: %lld)\n", group->period);
+
+	while (!group->must_stop)
+	{
+		size_t i;
+		urt_time deadline;
+
+		/* if paused, don't read any of the readers, but keep the period */
+		group->paused = group->must_pause;
+		if (group->paused)
+			goto skip_read;
+
+		/* read every reader in turn, but none past the start of the next period */
+		deadline = urt_task_next_period(task);
+		if (urt_sem_wait(group->lock, &group->must_stop))
+			goto skip_read;
+		for (i = 0; i < group->reader_count && !group->must_stop; ++i)
+		{
+			urt_time now = urt_get_time();
+
+			/* a reader failing to read (e.g. having no new data) doesn't affect the others */
+			skin_reader_read_latest(group->readers[i], deadline > now?deadline - now:0);
+		}
+		urt_sem_post(group->lock);
+
+		/* let the user know all readers of the group are read */
+		if (group->callbacks.read)
+			group->callbacks.read(group, group->callbacks.user_data);
+skip_read:
+		urt_task_wait_period(task);
+	}
+
+	group->running = false;
+	urt_dbg(group->skin->log_file, "reader group stopped\n");
+}
+
+SKIN_DEFINE_STORE_FUNCTION(reader_group);
+
+struct skin_reader_group *(skin_reader_group_add)(struct skin *skin, const urt_task_attr *task_attr_,
+		const struct skin_reader_group_callbacks *callbacks, int *error, ...)
+{
+	struct skin_reader_group *group = NULL;
+	int err = 0;
+	urt_task_attr task_attr;
+
+	if (_sanity_check_skin(skin) || task_attr_ == NULL || callbacks == NULL)
+		goto exit_bad_param;
+
+	task_attr = *task_attr_;
+
+	/* the group reads all its readers once every period, so it must be periodic */
+	if (task_attr.period <= 0 || task_attr.soft)
+		goto exit_bad_param;
+
+	/* default values */
+	if (!urt_priority_is_valid(task_attr.priority))
+		task_attr.priority = urt_priority(SKIN_CONFIG_PRIORITY_READER);
+
+	group = urt_mem_new(sizeof *group, &err);
+	if (group == NULL)
+		goto exit_no_mem;
+
+	*group = (struct skin_reader_group){
+		.running = true,
+		.must_pause = true,
+		.paused = true,
+		.period = task_attr.period,
+		.readers_mem_size = 8,
+		.callbacks = *callbacks,
+		.skin = skin,
+	};
+
+	group->readers = urt_mem_new(group->readers_mem_size * sizeof *group->readers, &err);
+	if (group->readers == NULL)
+		goto exit_no_mem;
+	group->lock = urt_sem_new(1, &err);
+	if (group->lock == NULL)
+		goto exit_no_lock;
+
+	group->task = urt_task_new(_reader_group_task, group, &task_attr, &err);
+	if (group->task == NULL)
+		goto exit_no_task;
+	if ((err = urt_task_start(group->task)))
+		goto exit_no_task;
+
+	/* store the pointer in internal memory */
+	_store_reader_group(skin, group);
+
+	/* call the object-specific init hook */
+	if (callbacks->init)
+		callbacks->init(group, callbacks->user_data);
+
+	return group;
+exit_no_task:
+	urt_task_delete(group->task);
+exit_no_lock:
+	urt_sem_delete(group->lock);
+exit_no_mem:
+	if (group)
+		urt_mem_delete(group->readers);
+	urt_mem_delete(group);
+exit_fail:
+	/* call the clean hook anyway, in case `user_data` requires cleanup */
+	if (callbacks && callbacks->clean)
+		callbacks->clean(NULL, callbacks->user_data);
+	if (error)
+		*error = err;
+	return NULL;
+exit_bad_param:
+	err = EINVAL;
+	goto exit_fail;
+}
+URT_EXPORT_SYMBOL(skin_reader_group_add);
+
+void skin_reader_group_remove(struct skin_reader_group *group)
+{
+	size_t i;
+	bool locked;
+
+	if (group == NULL || _sanity_check_skin(group->skin))
+		return;
+
+	/* remove it from local book-keeping */
+	_unstore_reader_group(group->skin, group);
+	if (group->skin->reader_group == group)
+		group->skin->reader_group = NULL;
+
+	/*
+	 * let the readers go, under the lock so that a reader concurrently leaving the group would find out it has
+	 * already left.  With no readers left, the task wouldn't read any of them either
+	 */
+	locked = urt_sem_wait(group->lock) == 0;
+	for (i = 0; i < group->reader_count; ++i)
+		group->readers[i]->group = NULL;
+	group->reader_count = 0;
+	if (locked)
+		urt_sem_post(group->lock);
+
+	/* stop the task */
+	group->must_stop = 1;
+	skin_internal_wait_termination(&group->running);
+	urt_task_delete(group->task);
+
+	/* call the object-specific clean hook */
+	if (group->callbacks.clean)
+		group->callbacks.clean(group, group->callbacks.user_data);
+
+	/* final cleanup */
+	urt_sem_delete(group->lock);
+	urt_mem_delete(group->readers);
+	urt_mem_delete(group);
+}
+URT_EXPORT_SYMBOL(skin_reader_group_remove);
+
+int skin_reader_group_pause(struct skin_reader_group *group)
+{
+	if (_sanity_check_group(group))
+		return EINVAL;
+	group->must_pause = true;
+	return 0;
+}
+URT_EXPORT_SYMBOL(skin_reader_group_pause);
+
+int skin_reader_group_resume(struct skin_reader_group *group)
+{
+	if (_sanity_check_group(group))
+		return EINVAL;
+	group->must_pause = false;
+	return 0;
+}
+URT_EXPORT_SYMBOL(skin_reader_group_resume);
+
+bool skin_reader_group_is_paused(struct skin_reader_group *group)
+{
+	if (_sanity_check_group(group))
+		return false;
+	return group->paused;
+}
+URT_EXPORT_SYMBOL(skin_reader_group_is_paused);
+
+size_t skin_reader_group_reader_count(struct skin_reader_group *group)
+{
+	if (_sanity_check_group(group))
+		return 0;
+	return group->reader_count;
+}
+URT_EXPORT_SYMBOL(skin_reader_group_reader_count);
+
+int skin_reader_join_group(struct skin_reader *reader, struct skin_reader_group *group)
+{
+	int err;
+
+	if (reader == NULL || !reader->pull || _sanity_check_group(group) || reader->skin != group->skin)
+		return EINVAL;
+	if (reader->group)
+		return EALREADY;
+
+	if ((err = urt_sem_wait(group->lock)))
+		return err;
+
+	/* if full, try to increase memory size */
+	if (group->reader_count >= group->readers_mem_size)
+	{
+		size_t new_size = 2 * group->readers_mem_size;
+		struct skin_reader **enlarged = urt_mem_resize(group->readers,
+				group->readers_mem_size * sizeof *group->readers,
+				new_size * sizeof *group->readers);
+
+		if (enlarged == NULL)
+		{
+			urt_sem_post(group->lock);
+			return ENOMEM;
+		}
+
+		group->readers = enlarged;
+		group->readers_mem_size = new_size;
+	}
+
+	group->readers[group->reader_count++] = reader;
+	reader->group = group;
+
+	urt_sem_post(group->lock);
+
+	return 0;
+}
+URT_EXPORT_SYMBOL(skin_reader_join_group);
+
+int skin_reader_leave_group(struct skin_reader *reader)
+{
+	struct skin_reader_group *group;
+	size_t i;
+	int err;
+
+	if (reader == NULL)
+		return EINVAL;
+
+	group = reader->group;
+	if (group == NULL)
+		return 0;
+
+	/* taking the lock makes sure the task is not in the middle of reading this reader */
+	if ((err = urt_sem_wait(group->lock)))
+		return err;
+
+	/* the group may have let go of the reader in the meantime, as it was being removed */
+	if (reader->group != group)
+	{
+		urt_sem_post(group->lock);
+		return 0;
+	}
+
+	/* the readers are kept in the order they joined, so they are read in the same order in every period */
+	for (i = 0; i < group->reader_count; ++i)
+		if (group->readers[i] == reader)
+			break;
+	if (i < group->reader_count)
+	{
+		for (; i + 1 < group->reader_count; ++i)
+			group->readers[i] = group->readers[i + 1];
+		--group->reader_count;
+	}
+	reader->group = NULL;
+
+	urt_sem_post(group->lock);
+
+	return 0;
+}
+URT_EXPORT_SYMBOL(skin_reader_leave_group);
+
+struct skin_reader_group *skin_reader_get_group(struct skin_reader *reader)
+{
+	if (reader == NULL)
+		return NULL;
+	return reader->group;
+}
+URT_EXPORT_SYMBOL(skin_reader_get_group);
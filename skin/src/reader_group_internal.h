@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef READER_GROUP_INTERNAL_H
+#define READER_GROUP_INTERNAL_H
+
+#include <skin_reader_group.h>
+#include "config.h"
+
+struct skin_reader;
+
+/* internal information on reader groups */
+struct skin_reader_group
+{
+	/* task control */
+	volatile sig_atomic_t must_stop;	/* if true, task will quit */
+	bool running;				/* if true, task is not yet terminated */
+	bool must_pause;			/* if true, task will pause */
+	bool paused;				/* if true, task is paused */
+	urt_time period;			/* period of the task */
+	urt_task *task;				/* the real-time task reading the readers of this group */
+	/* members */
+	urt_sem *lock;				/* protects the list of readers from changing while the task reads them */
+	struct skin_reader **readers;		/* the readers of the group, in the order they joined */
+	size_t reader_count;
+	size_t readers_mem_size;
+	/* acquisition */
+	struct skin_reader_group_callbacks callbacks;
+	/* references */
+	struct skin *skin;			/* reference back to the skin object */
+	uint16_t index;				/* index to skin's list of reader groups */
+};
+
+#endif
@@ -29,6 +29,9 @@
 #include "config.h"
 
 struct skin_user;
+struct skin_reader_group;
+struct skin_reader_pool;
+struct skin_shared_histograms;
 
 /* internal information on readers */
 struct skin_reader
@@ -39,26 +42,70 @@ struct skin_reader
 	bool must_pause;			/* if true, task will pause */
 	bool paused;				/* if true, task is paused */
 	bool soft;				/* whether its a soft real-time reader */
+	bool lossless;				/* whether it reads every frame from history */
+	bool pull;				/* whether it has no task and is read from in the caller's thread */
+	struct skin_reader_pool *pool;		/* the soft reader pool reading it instead of a task, if any */
+	uint32_t pool_slot;			/* index to the reader's slot in the pool (if pool) */
 	urt_time period;			/* period, if periodic */
-	urt_task *task;				/* the real-time task for this reader */
+	bool phase_locked;			/* whether the period is aligned to the writer's publish instants (if periodic) */
+	urt_task *task;				/* the real-time task for this reader (if not pull) */
 	/* synchronization */
 	urt_rwlock *rwls[SKIN_CONFIG_MAX_BUFFERS];
-						/* rwlocks for synchronization */
+						/* rwlocks for synchronization (if writer is not lock-free) */
 	urt_sem *writer_request,		/* request and response */
 		*writer_response;		/* semaphores for sporadic writers */
+	urt_sem *writer_new_frame;		/* semaphore to wait for new data on (if soft or sporadic, and writer periodic) */
 	urt_sem *request,			/* request and response */
 		*response;			/* semaphores for sporadic tasks */
+	int notify_fd;				/* descriptor notified of new frames, created on demand */
+	uint16_t notify_slot;			/*
+						 * index to the reader's notification slot in writer_info,
+						 * or SKIN_CONFIG_MAX_READER_NOTIFIERS if none was taken
+						 */
 	void *mem;				/* shared memory for reader */
+	void *history;				/* shared memory for history ring (if lossless) */
+	struct skin_shared_histograms *histograms;
+						/* shared memory for histograms of the writer and its readers */
+	void *copy;				/*
+						 * private copy of a buffer (if writer is lock-free), or of
+						 * frames taken from history (if lossless)
+						 */
+	uint64_t next_frame;			/* the next frame to read from history (if lossless) */
+	uint64_t frame_number;			/* frame number of the (first) frame being read */
+	urt_time write_time;			/* write time of the (first) frame being read */
+	urt_time publish_time;			/* time the (first) frame being read was made available */
+	struct
+	{
+		uint8_t last_buffer;
+		urt_time last_timestamp;
+		uint32_t last_seq;
+		uint64_t last_frame;
+		bool has_last_frame;
+		bool request_pending;		/* a request to a sporadic writer timed out, and its response is still due */
+	} pull_state;				/*
+						 * what was last read (if pull or pooled).  The task keeps these in local
+						 * variables, but pull reads need them between calls
+						 */
 	/* acquisition */
 	struct skin_reader_callbacks callbacks;
 	/* references */
 	struct skin *skin;			/* reference back to the skin object */
 	uint16_t writer_index;			/* index to writer_info in skin kernel */
+	uint16_t stats_slot;			/*
+						 * index to the reader's statistics slot in writer_info,
+						 * or SKIN_CONFIG_MAX_READER_STATS if none was free
+						 */
 	struct skin_user *user;			/* if a user reader, reference to the user */
+	struct skin_reader_group *group;	/* the group the reader is read by (if pull), or NULL */
 	uint16_t index;				/* index to skin's list of readers */
 	/* statistics */
 	struct skin_reader_statistics stats;
-	urt_mutex *stats_lock;
+	struct skin_histogram read_time_histogram;
+	struct skin_histogram latency_histogram;
+	uint32_t stats_seq;			/* sequence counter of statistics, odd while they are being updated */
 };
 
+/* a pull read, without checking whether the reader is a pull reader */
+int skin_internal_reader_read_latest(struct skin_reader *reader, urt_time timeout);
+
 #endif
@@ -0,0 +1,417 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define URT_LOG_PREFIX "skin: "
+#include <skin_base.h>
+#include "internal.h"
+#include "reader_internal.h"
+#include "notify.h"
+#include "reader_pool.h"
+
+static int _sanity_check_skin(struct skin *skin)
+{
+	return skin == NULL || skin->kernel == NULL?-1:0;
+}
+
+#ifndef __KERNEL__
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+/*
+ * the event data of the stop descriptor.  Slot events carry a slot index in the low 32 bits, which never reaches
+ * this value
+ */
+#define POOL_STOP_EVENT UINT64_MAX
+
+/*
+ * the readers are kept in slots whose index doesn't change while the reader is in the pool, so the index can be
+ * given to epoll.  The generation is changed whenever the slot is freed, so an event that was already taken out
+ * of epoll for a reader that is then removed can be recognized as stale.
+ */
+struct skin_reader_pool_slot
+{
+	struct skin_reader *reader;		/* the reader in this slot, or NULL if free */
+	uint32_t generation;			/* incremented every time the slot is freed */
+	bool busy;				/* whether a worker is reading the reader */
+	bool remove_waiting;			/* whether the reader is being removed, waiting for the worker to finish */
+};
+
+struct skin_reader_pool_worker
+{
+	struct skin_reader_pool *pool;		/* reference back to the pool */
+	urt_task *task;				/* the real-time task of this worker */
+	bool running;				/* if true, task is not yet terminated */
+};
+
+struct skin_reader_pool
+{
+	volatile sig_atomic_t must_stop;	/* if true, workers will quit */
+	int epoll_fd;				/* descriptor waiting on notification descriptors of all readers */
+	int stop_fd;				/* made readable to wake all workers up when they must stop */
+	urt_sem *lock;				/* protects the slots */
+	urt_sem *slot_released;			/* posted when a worker finishes reading a reader being removed */
+	unsigned int release_waiters;		/* number of removals waiting on slot_released */
+	struct skin_reader_pool_slot *slots;
+	uint32_t slot_count;			/* number of slots in use, free or not */
+	uint32_t slots_mem_size;
+	size_t reader_count;			/* number of readers in the pool */
+	struct skin_reader_pool_worker *workers;
+	unsigned int worker_count;
+	struct skin *skin;			/* reference back to the skin object */
+};
+
+/* wait for the reader's notification once, so that at most one worker reads it at a time */
+static int _arm_slot(struct skin_reader_pool *pool, uint32_t index, int op)
+{
+	struct epoll_event event = {
+		.events = EPOLLIN | EPOLLONESHOT,
+		.data.u64 = (uint64_t)pool->slots[index].generation << 32 | index,
+	};
+
+	return epoll_ctl(pool->epoll_fd, op, pool->slots[index].reader->notify_fd, &event)?errno:0;
+}
+
+static void _pool_worker(urt_task *task, void *data)
+{
+	struct skin_reader_pool_worker *worker = data;
+	struct skin_reader_pool *pool = worker->pool;
+
+	while (!pool->must_stop)
+	{
+		struct epoll_event event;
+		struct skin_reader *reader = NULL;
+		uint32_t index, generation;
+
+		/* there is no need for a timeout, as the workers are woken up through the stop descriptor to stop */
+		if (epoll_wait(pool->epoll_fd, &event, 1, -1) != 1)
+			continue;
+		if (event.data.u64 == POOL_STOP_EVENT)
+			continue;
+
+		index = (uint32_t)event.data.u64;
+		generation = event.data.u64 >> 32;
+
+		/* take the reader, unless it has been removed since the event */
+		if (urt_sem_wait(pool->lock, &pool->must_stop))
+			continue;
+		if (index < pool->slot_count && pool->slots[index].generation == generation)
+		{
+			reader = pool->slots[index].reader;
+			pool->slots[index].busy = reader != NULL;
+		}
+		urt_sem_post(pool->lock);
+
+		if (reader == NULL)
+			continue;
+
+		/*
+		 * consume the notification before reading, so a frame published during the read makes the descriptor
+		 * readable again.  Like a soft reader, a failed read (e.g. due to being paused) is simply skipped.
+		 */
+		skin_internal_notify_clear(reader->notify_fd);
+		skin_internal_reader_read_latest(reader, SKIN_CONFIG_EVENT_MAX_DELAY);
+
+		/* let other workers take the reader on its next notification, or let it be removed if being removed */
+		urt_sem_wait(pool->lock);
+		pool->slots[index].busy = false;
+		if (pool->slots[index].remove_waiting)
+		{
+			/* the removals waiting may be for other readers too, so all are woken up to check their own */
+			pool->slots[index].remove_waiting = false;
+			for (; pool->release_waiters > 0; --pool->release_waiters)
+				urt_sem_post(pool->slot_released);
+		}
+		else
+			_arm_slot(pool, index, EPOLL_CTL_MOD);
+		urt_sem_post(pool->lock);
+	}
+
+	worker->running = false;
+}
+
+struct skin_reader_pool *skin_internal_reader_pool_new(struct skin *skin, unsigned int worker_count,
+		const urt_task_attr *task_attr_, int *error)
+{
+	struct skin_reader_pool *pool;
+	urt_task_attr task_attr = {0};
+	unsigned int i;
+
+	if (task_attr_)
+		task_attr = *task_attr_;
+
+	/* the workers wait for notifications, so they behave like soft readers */
+	task_attr.period = 0;
+	task_attr.soft = true;
+	if (!urt_priority_is_valid(task_attr.priority))
+		task_attr.priority = urt_priority(SKIN_CONFIG_PRIORITY_READER);
+
+	pool = urt_mem_new(sizeof *pool, error);
+	if (pool == NULL)
+		goto exit_no_mem;
+
+	*pool = (struct skin_reader_pool){
+		.epoll_fd = -1,
+		.stop_fd = -1,
+		.slots_mem_size = 16,
+		.skin = skin,
+	};
+
+	pool->slots = urt_mem_new(pool->slots_mem_size * sizeof *pool->slots, error);
+	pool->workers = urt_mem_new(worker_count * sizeof *pool->workers, error);
+	if (pool->slots == NULL || pool->workers == NULL)
+		goto exit_fail;
+	pool->lock = urt_sem_new(1, error);
+	if (pool->lock == NULL)
+		goto exit_fail;
+	pool->slot_released = urt_sem_new(0, error);
+	if (pool->slot_released == NULL)
+		goto exit_fail;
+	pool->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (pool->epoll_fd < 0)
+		goto exit_no_fd;
+	pool->stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (pool->stop_fd < 0)
+		goto exit_no_fd;
+
+	/* the stop descriptor is level-triggered and is never read, so once written, it wakes up all workers */
+	if (epoll_ctl(pool->epoll_fd, EPOLL_CTL_ADD, pool->stop_fd, &(struct epoll_event){
+				.events = EPOLLIN,
+				.data.u64 = POOL_STOP_EVENT,
+			}))
+		goto exit_no_fd;
+
+	for (i = 0; i < worker_count; ++i)
+	{
+		struct skin_reader_pool_worker *worker = &pool->workers[i];
+
+		/* only the workers created so far are cleaned up, if a later one fails */
+		*worker = (struct skin_reader_pool_worker){
+			.pool = pool,
+		};
+		pool->worker_count = i + 1;
+
+		worker->task = urt_task_new(_pool_worker, worker, &task_attr, error);
+		if (worker->task == NULL)
+			goto exit_no_task;
+		worker->running = true;
+		if ((*error = urt_task_start(worker->task)))
+			goto exit_no_task;
+	}
+
+	return pool;
+exit_no_task:
+	/* the worker that failed to start is not running */
+	pool->workers[i].running = false;
+	skin_internal_reader_pool_free(pool);
+	return NULL;
+exit_no_fd:
+	*error = errno;
+exit_fail:
+	skin_internal_reader_pool_free(pool);
+exit_no_mem:
+	return NULL;
+}
+
+void skin_internal_reader_pool_free(struct skin_reader_pool *pool)
+{
+	unsigned int i;
+
+	if (pool == NULL)
+		return;
+
+	/* tell all workers to stop first and wake them up, so their delay in responding would be spent in parallel */
+	pool->must_stop = 1;
+	if (pool->stop_fd >= 0)
+		if (write(pool->stop_fd, &(uint64_t){1}, sizeof(uint64_t)) < 0)
+			internal_error("failed to wake up the soft reader pool workers to stop\n");
+	for (i = 0; i < pool->worker_count; ++i)
+	{
+		skin_internal_wait_termination(&pool->workers[i].running);
+		if (pool->workers[i].task)
+			urt_task_delete(pool->workers[i].task);
+	}
+
+	if (pool->stop_fd >= 0)
+		close(pool->stop_fd);
+	if (pool->epoll_fd >= 0)
+		close(pool->epoll_fd);
+	urt_sem_delete(pool->slot_released);
+	urt_sem_delete(pool->lock);
+	urt_mem_delete(pool->workers);
+	urt_mem_delete(pool->slots);
+	urt_mem_delete(pool);
+}
+
+size_t skin_internal_reader_pool_reader_count(struct skin_reader_pool *pool)
+{
+	return pool?pool->reader_count:0;
+}
+
+int skin_internal_reader_pool_add(struct skin_reader_pool *pool, struct skin_reader *reader)
+{
+	uint32_t i;
+	int err;
+
+	if (pool == NULL || reader == NULL || reader->task != NULL || reader->pull || reader->pool != NULL)
+		return EINVAL;
+
+	/* the reader is notified through its notification descriptor, which is taken on behalf of the pool */
+	reader->pool = pool;
+	if (skin_reader_get_notify_fd(reader, &err) < 0)
+		goto exit_no_fd;
+
+	if ((err = urt_sem_wait(pool->lock)))
+		goto exit_no_lock;
+
+	/* find a free slot, or add a new one */
+	for (i = 0; i < pool->slot_count; ++i)
+		if (pool->slots[i].reader == NULL && !pool->slots[i].busy)
+			break;
+	if (i == pool->slot_count && pool->slot_count >= pool->slots_mem_size)
+	{
+		uint32_t new_size = 2 * pool->slots_mem_size;
+		struct skin_reader_pool_slot *enlarged = urt_mem_resize(pool->slots,
+				pool->slots_mem_size * sizeof *pool->slots,
+				new_size * sizeof *pool->slots);
+
+		err = ENOMEM;
+		if (enlarged == NULL)
+			goto exit_no_mem;
+
+		pool->slots = enlarged;
+		pool->slots_mem_size = new_size;
+	}
+	if (i == pool->slot_count)
+		pool->slots[pool->slot_count++] = (struct skin_reader_pool_slot){0};
+
+	pool->slots[i].reader = reader;
+	if ((err = _arm_slot(pool, i, EPOLL_CTL_ADD)))
+		goto exit_no_epoll;
+
+	reader->pool_slot = i;
+	++pool->reader_count;
+
+	urt_sem_post(pool->lock);
+
+	return 0;
+exit_no_epoll:
+	pool->slots[i].reader = NULL;
+exit_no_mem:
+	urt_sem_post(pool->lock);
+exit_no_lock:
+exit_no_fd:
+	reader->pool = NULL;
+	return err;
+}
+
+void skin_internal_reader_pool_remove(struct skin_reader *reader)
+{
+	struct skin_reader_pool *pool;
+	struct skin_reader_pool_slot *slot;
+
+	if (reader == NULL || reader->pool == NULL)
+		return;
+
+	pool = reader->pool;
+
+	urt_sem_wait(pool->lock);
+
+	/*
+	 * if a worker is reading the reader, let it finish.  The worker wakes up the waiting removals once done, as it
+	 * sees the reader is being removed.  The slots may be enlarged (and therefore moved) in the meantime
+	 */
+	slot = &pool->slots[reader->pool_slot];
+	while (slot->busy)
+	{
+		slot->remove_waiting = true;
+		++pool->release_waiters;
+		urt_sem_post(pool->lock);
+		urt_sem_wait(pool->slot_released);
+		urt_sem_wait(pool->lock);
+		slot = &pool->slots[reader->pool_slot];
+	}
+
+	epoll_ctl(pool->epoll_fd, EPOLL_CTL_DEL, reader->notify_fd, NULL);
+	slot->reader = NULL;
+	++slot->generation;
+	--pool->reader_count;
+
+	urt_sem_post(pool->lock);
+
+	reader->pool = NULL;
+}
+
+#else
+
+struct skin_reader_pool *skin_internal_reader_pool_new(struct skin *skin, unsigned int worker_count,
+		const urt_task_attr *task_attr, int *error)
+{
+	*error = ENOTSUP;
+	return NULL;
+}
+
+void skin_internal_reader_pool_free(struct skin_reader_pool *pool)
+{
+}
+
+size_t skin_internal_reader_pool_reader_count(struct skin_reader_pool *pool)
+{
+	return 0;
+}
+
+int skin_internal_reader_pool_add(struct skin_reader_pool *pool, struct skin_reader *reader)
+{
+	return ENOTSUP;
+}
+
+void skin_internal_reader_pool_remove(struct skin_reader *reader)
+{
+}
+
+#endif
+
+int skin_set_soft_reader_pool(struct skin *skin, unsigned int worker_count, const urt_task_attr *task_attr)
+{
+	int err = 0;
+
+	if (_sanity_check_skin(skin))
+		return EINVAL;
+
+	/* the workers of the current pool are replaced only if they have no readers to read */
+	if (skin_internal_reader_pool_reader_count(skin->soft_reader_pool) > 0)
+		return EBUSY;
+
+	skin_internal_reader_pool_free(skin->soft_reader_pool);
+	skin->soft_reader_pool = NULL;
+
+	if (worker_count == 0)
+		return 0;
+
+	skin->soft_reader_pool = skin_internal_reader_pool_new(skin, worker_count, task_attr, &err);
+
+	return err;
+}
+URT_EXPORT_SYMBOL(skin_set_soft_reader_pool);
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef READER_POOL_H
+#define READER_POOL_H
+
+#include <urt.h>
+
+struct skin;
+struct skin_reader;
+struct skin_reader_pool;
+
+/*
+ * a pool of worker tasks shared by soft readers.  Instead of each soft reader having a task that waits for the
+ * writer to publish a new frame, the readers are notified through their notification descriptors (see notify.h),
+ * which are all waited on by the workers.  The first free worker reads the reader whose writer has published.
+ *
+ * This is only available in user space.  In kernel space, new fails with ENOTSUP.
+ */
+
+/* create a pool with the given number of workers.  On error, NULL is returned */
+struct skin_reader_pool *skin_internal_reader_pool_new(struct skin *skin, unsigned int worker_count,
+		const urt_task_attr *task_attr, int *error);
+/* stop the workers and free the pool, which must have no readers */
+void skin_internal_reader_pool_free(struct skin_reader_pool *pool);
+/* the number of readers in the pool */
+size_t skin_internal_reader_pool_reader_count(struct skin_reader_pool *pool);
+/* make the pool read the reader, which must be a soft reader of a periodic writer and have no task */
+int skin_internal_reader_pool_add(struct skin_reader_pool *pool, struct skin_reader *reader);
+/* stop reading the reader, if it is in a pool.  After return, no worker is reading the reader */
+void skin_internal_reader_pool_remove(struct skin_reader *reader);
+
+#endif
@@ -0,0 +1,501 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define URT_LOG_PREFIX "skin: "
+#include <pthread.h>
+#include <skin_responses.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define HAVE_X86_SIMD 1
+# include <immintrin.h>
+# define TARGET(t) __attribute__((target(t)))
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+# define HAVE_NEON_SIMD 1
+# include <arm_neon.h>
+#endif
+
+/*
+ * response * 255 / 65535 is the same as response / 257, which for 16-bit values is exactly
+ * (response * 65281) >> 24.  The vectorized implementations use the latter.
+ */
+#define U8_SCALE_MUL 65281
+#define U8_SCALE_SHIFT 24
+#define FLOAT_SCALE (1.0f / SKIN_SENSOR_RESPONSE_MAX)
+
+struct responses_ops
+{
+	const char *name;
+	void (*to_u8)(uint8_t *dst, const skin_sensor_response *src, size_t count);
+	void (*to_float)(float *dst, const skin_sensor_response *src, size_t count);
+	void (*subtract_baseline)(skin_sensor_response *dst, const skin_sensor_response *src,
+			const skin_sensor_response *baseline, size_t count);
+	void (*min_max)(skin_sensor_response *min, skin_sensor_response *max,
+			const skin_sensor_response *src, size_t count);
+	size_t (*threshold)(uint8_t *mask, const skin_sensor_response *src,
+			skin_sensor_response threshold, size_t count);
+};
+
+/* scalar implementation, also used by the others for the elements that don't fill a vector */
+
+static void _scalar_to_u8(uint8_t *dst, const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+	for (i = 0; i < count; ++i)
+		dst[i] = (uint32_t)src[i] * 255 / SKIN_SENSOR_RESPONSE_MAX;
+}
+
+static void _scalar_to_float(float *dst, const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+	for (i = 0; i < count; ++i)
+		dst[i] = src[i] * FLOAT_SCALE;
+}
+
+static void _scalar_subtract_baseline(skin_sensor_response *dst, const skin_sensor_response *src,
+		const skin_sensor_response *baseline, size_t count)
+{
+	size_t i;
+	for (i = 0; i < count; ++i)
+		dst[i] = src[i] > baseline[i]?src[i] - baseline[i]:0;
+}
+
+static void _scalar_min_max(skin_sensor_response *min, skin_sensor_response *max,
+		const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+	for (i = 0; i < count; ++i)
+	{
+		if (src[i] < min[i])
+			min[i] = src[i];
+		if (src[i] > max[i])
+			max[i] = src[i];
+	}
+}
+
+static size_t _scalar_threshold(uint8_t *mask, const skin_sensor_response *src,
+		skin_sensor_response threshold, size_t count)
+{
+	size_t i;
+	size_t above = 0;
+	for (i = 0; i < count; ++i)
+	{
+		mask[i] = src[i] >= threshold;
+		above += mask[i];
+	}
+	return above;
+}
+
+static const struct responses_ops _scalar_ops = {
+	.name = "scalar",
+	.to_u8 = _scalar_to_u8,
+	.to_float = _scalar_to_float,
+	.subtract_baseline = _scalar_subtract_baseline,
+	.min_max = _scalar_min_max,
+	.threshold = _scalar_threshold,
+};
+
+#ifdef HAVE_X86_SIMD
+
+/* SSE2 implementation, processing 8 responses at a time */
+
+TARGET("sse2") static void _sse2_to_u8(uint8_t *dst, const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+	const __m128i mul = _mm_set1_epi16((short)U8_SCALE_MUL);
+
+	for (i = 0; i + 16 <= count; i += 16)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(src + i + 8));
+		a = _mm_srli_epi16(_mm_mulhi_epu16(a, mul), U8_SCALE_SHIFT - 16);
+		b = _mm_srli_epi16(_mm_mulhi_epu16(b, mul), U8_SCALE_SHIFT - 16);
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(a, b));
+	}
+	_scalar_to_u8(dst + i, src + i, count - i);
+}
+
+TARGET("sse2") static void _sse2_to_float(float *dst, const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps(FLOAT_SCALE);
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+		_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(a, zero)), scale));
+		_mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(a, zero)), scale));
+	}
+	_scalar_to_float(dst + i, src + i, count - i);
+}
+
+TARGET("sse2") static void _sse2_subtract_baseline(skin_sensor_response *dst, const skin_sensor_response *src,
+		const skin_sensor_response *baseline, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(baseline + i));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_subs_epu16(a, b));
+	}
+	_scalar_subtract_baseline(dst + i, src + i, baseline + i, count - i);
+}
+
+TARGET("sse2") static void _sse2_min_max(skin_sensor_response *min, skin_sensor_response *max,
+		const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+
+	/* SSE2 has no unsigned 16-bit min/max, but min(a, b) = a - (a -sat b) and max(a, b) = b + (a -sat b) */
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i mn = _mm_loadu_si128((const __m128i *)(min + i));
+		__m128i mx = _mm_loadu_si128((const __m128i *)(max + i));
+		mn = _mm_sub_epi16(mn, _mm_subs_epu16(mn, s));
+		mx = _mm_add_epi16(mx, _mm_subs_epu16(s, mx));
+		_mm_storeu_si128((__m128i *)(min + i), mn);
+		_mm_storeu_si128((__m128i *)(max + i), mx);
+	}
+	_scalar_min_max(min + i, max + i, src + i, count - i);
+}
+
+TARGET("sse2") static size_t _sse2_threshold(uint8_t *mask, const skin_sensor_response *src,
+		skin_sensor_response threshold, size_t count)
+{
+	size_t i;
+	size_t above = 0;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi8(1);
+	const __m128i t = _mm_set1_epi16((short)threshold);
+
+	for (i = 0; i + 16 <= count; i += 16)
+	{
+		/* src >= threshold is the same as threshold -sat src == 0 */
+		__m128i a = _mm_cmpeq_epi16(_mm_subs_epu16(t, _mm_loadu_si128((const __m128i *)(src + i))), zero);
+		__m128i b = _mm_cmpeq_epi16(_mm_subs_epu16(t, _mm_loadu_si128((const __m128i *)(src + i + 8))), zero);
+		__m128i m = _mm_packs_epi16(a, b);
+		_mm_storeu_si128((__m128i *)(mask + i), _mm_and_si128(m, one));
+		above += __builtin_popcount(_mm_movemask_epi8(m));
+	}
+	return above + _scalar_threshold(mask + i, src + i, threshold, count - i);
+}
+
+static const struct responses_ops _sse2_ops = {
+	.name = "sse2",
+	.to_u8 = _sse2_to_u8,
+	.to_float = _sse2_to_float,
+	.subtract_baseline = _sse2_subtract_baseline,
+	.min_max = _sse2_min_max,
+	.threshold = _sse2_threshold,
+};
+
+/*
+ * AVX2 implementation, processing 16 responses at a time.  Note that packing works within each 128-bit lane,
+ * so the packed results need to be permuted back in order.
+ */
+
+TARGET("avx2") static void _avx2_to_u8(uint8_t *dst, const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+	const __m256i mul = _mm256_set1_epi16((short)U8_SCALE_MUL);
+
+	for (i = 0; i + 32 <= count; i += 32)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i *)(src + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(src + i + 16));
+		a = _mm256_srli_epi16(_mm256_mulhi_epu16(a, mul), U8_SCALE_SHIFT - 16);
+		b = _mm256_srli_epi16(_mm256_mulhi_epu16(b, mul), U8_SCALE_SHIFT - 16);
+		_mm256_storeu_si256((__m256i *)(dst + i),
+				_mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+	_sse2_to_u8(dst + i, src + i, count - i);
+}
+
+TARGET("avx2") static void _avx2_to_float(float *dst, const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+	const __m256 scale = _mm256_set1_ps(FLOAT_SCALE);
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		__m256i a = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src + i)));
+		_mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(a), scale));
+	}
+	_scalar_to_float(dst + i, src + i, count - i);
+}
+
+TARGET("avx2") static void _avx2_subtract_baseline(skin_sensor_response *dst, const skin_sensor_response *src,
+		const skin_sensor_response *baseline, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + 16 <= count; i += 16)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i *)(src + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(baseline + i));
+		_mm256_storeu_si256((__m256i *)(dst + i), _mm256_subs_epu16(a, b));
+	}
+	_sse2_subtract_baseline(dst + i, src + i, baseline + i, count - i);
+}
+
+TARGET("avx2") static void _avx2_min_max(skin_sensor_response *min, skin_sensor_response *max,
+		const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + 16 <= count; i += 16)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+		__m256i mn = _mm256_loadu_si256((const __m256i *)(min + i));
+		__m256i mx = _mm256_loadu_si256((const __m256i *)(max + i));
+		_mm256_storeu_si256((__m256i *)(min + i), _mm256_min_epu16(mn, s));
+		_mm256_storeu_si256((__m256i *)(max + i), _mm256_max_epu16(mx, s));
+	}
+	_sse2_min_max(min + i, max + i, src + i, count - i);
+}
+
+TARGET("avx2") static size_t _avx2_threshold(uint8_t *mask, const skin_sensor_response *src,
+		skin_sensor_response threshold, size_t count)
+{
+	size_t i;
+	size_t above = 0;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i one = _mm256_set1_epi8(1);
+	const __m256i t = _mm256_set1_epi16((short)threshold);
+
+	for (i = 0; i + 32 <= count; i += 32)
+	{
+		__m256i a = _mm256_cmpeq_epi16(_mm256_subs_epu16(t, _mm256_loadu_si256((const __m256i *)(src + i))), zero);
+		__m256i b = _mm256_cmpeq_epi16(_mm256_subs_epu16(t, _mm256_loadu_si256((const __m256i *)(src + i + 16))),
+				zero);
+		__m256i m = _mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+		_mm256_storeu_si256((__m256i *)(mask + i), _mm256_and_si256(m, one));
+		above += __builtin_popcount((unsigned int)_mm256_movemask_epi8(m));
+	}
+	return above + _sse2_threshold(mask + i, src + i, threshold, count - i);
+}
+
+static const struct responses_ops _avx2_ops = {
+	.name = "avx2",
+	.to_u8 = _avx2_to_u8,
+	.to_float = _avx2_to_float,
+	.subtract_baseline = _avx2_subtract_baseline,
+	.min_max = _avx2_min_max,
+	.threshold = _avx2_threshold,
+};
+
+#endif
+
+#ifdef HAVE_NEON_SIMD
+
+/* NEON implementation, processing 8 responses at a time */
+
+static void _neon_to_u8(uint8_t *dst, const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+	const uint16x4_t mul = vdup_n_u16(U8_SCALE_MUL);
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		uint16x8_t a = vld1q_u16(src + i);
+		uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(a), mul), 16);
+		uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(a), mul), 16);
+		vst1_u8(dst + i, vshrn_n_u16(vcombine_u16(lo, hi), U8_SCALE_SHIFT - 16));
+	}
+	_scalar_to_u8(dst + i, src + i, count - i);
+}
+
+static void _neon_to_float(float *dst, const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		uint16x8_t a = vld1q_u16(src + i);
+		vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(a))), FLOAT_SCALE));
+		vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(a))), FLOAT_SCALE));
+	}
+	_scalar_to_float(dst + i, src + i, count - i);
+}
+
+static void _neon_subtract_baseline(skin_sensor_response *dst, const skin_sensor_response *src,
+		const skin_sensor_response *baseline, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + 8 <= count; i += 8)
+		vst1q_u16(dst + i, vqsubq_u16(vld1q_u16(src + i), vld1q_u16(baseline + i)));
+	_scalar_subtract_baseline(dst + i, src + i, baseline + i, count - i);
+}
+
+static void _neon_min_max(skin_sensor_response *min, skin_sensor_response *max,
+		const skin_sensor_response *src, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		uint16x8_t s = vld1q_u16(src + i);
+		vst1q_u16(min + i, vminq_u16(vld1q_u16(min + i), s));
+		vst1q_u16(max + i, vmaxq_u16(vld1q_u16(max + i), s));
+	}
+	_scalar_min_max(min + i, max + i, src + i, count - i);
+}
+
+static size_t _neon_threshold(uint8_t *mask, const skin_sensor_response *src,
+		skin_sensor_response threshold, size_t count)
+{
+	size_t i;
+	size_t above = 0;
+	const uint16x8_t t = vdupq_n_u16(threshold);
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		uint8x8_t m = vand_u8(vmovn_u16(vcgeq_u16(vld1q_u16(src + i), t)), vdup_n_u8(1));
+		vst1_u8(mask + i, m);
+		/* each byte of m is 0 or 1, so their sum is the number of set bits */
+		above += __builtin_popcountll(vget_lane_u64(vreinterpret_u64_u8(m), 0));
+	}
+	return above + _scalar_threshold(mask + i, src + i, threshold, count - i);
+}
+
+static const struct responses_ops _neon_ops = {
+	.name = "neon",
+	.to_u8 = _neon_to_u8,
+	.to_float = _neon_to_float,
+	.subtract_baseline = _neon_subtract_baseline,
+	.min_max = _neon_min_max,
+	.threshold = _neon_threshold,
+};
+
+#endif
+
+static const struct responses_ops *_ops = &_scalar_ops;
+static pthread_once_t _ops_once = PTHREAD_ONCE_INIT;
+
+static const struct responses_ops *_get_simd_ops(enum skin_responses_simd simd)
+{
+	switch (simd)
+	{
+	case SKIN_RESPONSES_SIMD_SCALAR:
+		return &_scalar_ops;
+#ifdef HAVE_X86_SIMD
+	case SKIN_RESPONSES_SIMD_SSE2:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse2")?&_sse2_ops:NULL;
+	case SKIN_RESPONSES_SIMD_AVX2:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2")?&_avx2_ops:NULL;
+#endif
+#ifdef HAVE_NEON_SIMD
+	case SKIN_RESPONSES_SIMD_NEON:
+		return &_neon_ops;
+#endif
+	default:
+		return NULL;
+	}
+}
+
+static void _select_best_ops(void)
+{
+	/* in order of preference */
+	static const enum skin_responses_simd preference[] = {
+		SKIN_RESPONSES_SIMD_AVX2,
+		SKIN_RESPONSES_SIMD_SSE2,
+		SKIN_RESPONSES_SIMD_NEON,
+	};
+	const struct responses_ops *ops = NULL;
+	size_t i;
+
+	for (i = 0; ops == NULL && i < sizeof preference / sizeof *preference; ++i)
+		ops = _get_simd_ops(preference[i]);
+
+	_ops = ops?ops:&_scalar_ops;
+}
+static inline const struct responses_ops *_get_ops(void)
+{
+	pthread_once(&_ops_once, _select_best_ops);
+	return _ops;
+}
+
+void skin_responses_to_u8(uint8_t *dst, const skin_sensor_response *src, size_t count)
+{
+	_get_ops()->to_u8(dst, src, count);
+}
+
+void skin_responses_to_float(float *dst, const skin_sensor_response *src, size_t count)
+{
+	_get_ops()->to_float(dst, src, count);
+}
+
+void skin_responses_subtract_baseline(skin_sensor_response *dst, const skin_sensor_response *src,
+		const skin_sensor_response *baseline, size_t count)
+{
+	_get_ops()->subtract_baseline(dst, src, baseline, count);
+}
+
+void skin_responses_min_max(skin_sensor_response *min, skin_sensor_response *max,
+		const skin_sensor_response *src, size_t count)
+{
+	_get_ops()->min_max(min, max, src, count);
+}
+
+size_t skin_responses_threshold(uint8_t *mask, const skin_sensor_response *src,
+		skin_sensor_response threshold, size_t count)
+{
+	return _get_ops()->threshold(mask, src, threshold, count);
+}
+
+int skin_responses_select_simd(enum skin_responses_simd simd)
+{
+	const struct responses_ops *ops;
+
+	if (simd < SKIN_RESPONSES_SIMD_BEST || simd > SKIN_RESPONSES_SIMD_NEON)
+		return EINVAL;
+
+	/* make sure the first use doesn't override the selection */
+	pthread_once(&_ops_once, _select_best_ops);
+	if (simd == SKIN_RESPONSES_SIMD_BEST)
+	{
+		_select_best_ops();
+		return 0;
+	}
+
+	ops = _get_simd_ops(simd);
+	if (ops == NULL)
+		return ENOTSUP;
+
+	_ops = ops;
+
+	return 0;
+}
+
+const char *skin_responses_simd_name(void)
+{
+	return _get_ops()->name;
+}
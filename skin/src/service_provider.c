@@ -26,6 +26,7 @@
 #include <skin_base.h>
 #include "internal.h"
 #include "names.h"
+#include "notify.h"
 
 static int _sanity_check_skin(struct skin *skin)
 {
@@ -34,21 +35,20 @@ static int _sanity_check_skin(struct skin *skin)
 
 static struct skin_writer *_revive_writer(struct skin *skin, const struct skin_writer_attr *attr, const urt_task_attr *task_attr, int *error)
 {
-	unsigned int i;
-	struct skin_kernel *sk = skin->kernel;
+	uint16_t i = SKIN_KERNEL_INVALID_INDEX;
 	struct skin_writer *writer = NULL;
 
-	for (i = 0; i < sk->max_writer_count; ++i)
+	while ((i = skin_internal_writer_find(skin, attr->name, i)) != SKIN_KERNEL_INVALID_INDEX)
 	{
-		struct skin_writer_info *w = &sk->writers[i];
+		struct skin_writer_info *w = skin_internal_writer_info(skin, i);
 
-		if (!w->active && w->readers_attached > 0
-			&& skin_internal_name_cmp_prefix(w->attr.prefix, attr->name) == 0)
+		if (!w->active && w->readers_attached > 0)
 		{
 			*error = EEXIST;
 
 			/* make sure the new and old attributes match */
 			if (w->attr.buffer_size != attr->buffer_size || w->attr.buffer_count != attr->buffer_count
+					|| w->attr.lock_free != attr->lock_free || w->attr.history != attr->history
 					|| w->period != task_attr->period)
 				goto exit_fail;
 
@@ -60,6 +60,9 @@ static struct skin_writer *_revive_writer(struct skin *skin, const struct skin_w
 
 			w->active = true;
 
+			/* the revived writer starts its statistics anew.  Its histogram is reset once attached to */
+			w->stats = (struct skin_writer_statistics){0};
+
 			*writer = (struct skin_writer){
 				.info_index = i,
 			};
@@ -74,42 +77,42 @@ exit_fail:
 
 static struct skin_writer *_get_free_writer(struct skin *skin, const struct skin_writer_attr *attr, const urt_task_attr *task_attr, int *error)
 {
-	unsigned int i;
-	struct skin_kernel *sk = skin->kernel;
+	uint16_t i;
 	struct skin_writer *writer = NULL;
+	struct skin_writer_info *w;
 
-	for (i = 0; i < sk->max_writer_count; ++i)
-	{
-		struct skin_writer_info *w = &sk->writers[i];
-
-		if (!w->active && w->readers_attached == 0)
-		{
-			writer = urt_mem_new(sizeof *writer, error);
-			if (writer == NULL)
-				goto exit_fail;
-
-			*w = (struct skin_writer_info){
-				.attr = {
-					.buffer_size = attr->buffer_size,
-					.buffer_count = attr->buffer_count,
-				},
-				.period = task_attr->period,
-				.driver_index = sk->max_driver_count,
-				.active = true,
-			};
-			skin_internal_name_set_prefix(w->attr.prefix, attr->name, NULL);
-			*writer = (struct skin_writer){
-				.info_index = i,
-			};
-
-			break;
-		}
-	}
-
+	writer = urt_mem_new(sizeof *writer, error);
 	if (writer == NULL)
-		*error = ENOSPC;
-exit_fail:
+		goto exit_fail;
+
+	i = skin_internal_writer_claim(skin);
+	if (i == SKIN_KERNEL_INVALID_INDEX)
+		goto exit_no_slot;
+
+	w = skin_internal_writer_info(skin, i);
+	*w = (struct skin_writer_info){
+		.attr = {
+			.buffer_size = attr->buffer_size,
+			.buffer_count = attr->buffer_count,
+			.lock_free = attr->lock_free,
+			.history = attr->history,
+		},
+		.period = task_attr->period,
+		.driver_index = SKIN_KERNEL_INVALID_INDEX,
+		.active = true,
+	};
+	skin_internal_name_set_prefix(w->attr.prefix, attr->name, NULL);
+	skin_internal_writer_link(skin, i);
+	*writer = (struct skin_writer){
+		.info_index = i,
+	};
+
 	return writer;
+exit_no_slot:
+	*error = ENOSPC;
+	urt_mem_delete(writer);
+exit_fail:
+	return NULL;
 }
 
 SKIN_DEFINE_STORE_FUNCTION(writer);
@@ -170,6 +173,7 @@ struct skin_writer *(skin_service_add)(struct skin *skin, const struct skin_writ
 		.running = true,
 		.must_pause = true,
 		.paused = true,
+		.notify_sender = -1,
 		.callbacks = *callbacks,
 		.skin = skin,
 		.info_index = writer->info_index,
@@ -189,7 +193,17 @@ struct skin_writer *(skin_service_add)(struct skin *skin, const struct skin_writ
 		if (writer->request == NULL || writer->response == NULL)
 			goto exit_no_lock;
 	}
-	for (b = 0; b < attr.buffer_count; ++b)
+	else
+	{
+		skin_internal_name_set(name, attr.name, "NEW");
+		if (revived)
+			writer->new_frame = urt_shsem_attach(name, &err);
+		else
+			writer->new_frame = urt_shsem_new(name, 0, &err);
+		if (writer->new_frame == NULL)
+			goto exit_no_lock;
+	}
+	for (b = 0; b < attr.buffer_count && !attr.lock_free; ++b)
 	{
 		skin_internal_name_set_indexed(name, attr.name, "RW", b);
 		if (revived)
@@ -206,9 +220,56 @@ struct skin_writer *(skin_service_add)(struct skin *skin, const struct skin_writ
 		writer->mem = urt_shmem_new(name, attr.buffer_count * attr.buffer_size, &err);
 	if (writer->mem == NULL)
 		goto exit_no_mem;
+	if (attr.history > 0)
+	{
+		struct skin_writer_attr_internal *attr_internal = &skin_internal_writer_info(skin, writer->info_index)->attr;
+
+		skin_internal_name_set(name, attr.name, "HST");
+		if (revived)
+			writer->history = urt_shmem_attach(name, &err);
+		else
+			writer->history = urt_shmem_new(name, attr.history * skin_internal_history_frame_size(attr_internal), &err);
+		if (writer->history == NULL)
+			goto exit_no_mem;
+	}
+	skin_internal_name_set(name, attr.name, "HSG");
+	if (revived)
+		writer->histograms = urt_shmem_attach(name, &err);
+	else
+		writer->histograms = urt_shmem_new(name, sizeof *writer->histograms, &err);
+	if (writer->histograms == NULL)
+		goto exit_no_mem;
+	if (revived)
+		writer->histograms->write_time = (struct skin_histogram){0};
+	else
+		memset(writer->histograms, 0, sizeof *writer->histograms);
+
+	/* create the descriptor to notify readers with, unless not supported, in which case readers can't ask for one */
+	writer->notify_sender = skin_internal_notify_sender(&err);
+	if (writer->notify_sender < 0 && err != ENOTSUP)
+		goto exit_no_sender;
 
-	/* create lock for stats, but failure doesn't matter */
-	writer->stats_lock = urt_mutex_new();
+	/* the notifications are sent by a soft task, so the cost of the system calls isn't paid by the writer task */
+	if (writer->notify_sender >= 0)
+	{
+		urt_task_attr notify_attr = {
+			.priority = task_attr.priority,
+			.soft = true,
+		};
+
+		writer->notify_request = urt_sem_new(0, &err);
+		if (writer->notify_request == NULL)
+			goto exit_no_notify;
+		writer->notify_task = urt_task_new(skin_internal_writer_notify_task, writer, &notify_attr, &err);
+		if (writer->notify_task == NULL)
+			goto exit_no_notify;
+		writer->notify_running = true;
+		if ((err = urt_task_start(writer->notify_task)))
+		{
+			writer->notify_running = false;
+			goto exit_no_notify;
+		}
+	}
 
 	/* create the task itself */
 	writer->task = urt_task_new(skin_writer_acquisition_task, writer, &task_attr, &err);
@@ -230,6 +291,8 @@ struct skin_writer *(skin_service_add)(struct skin *skin, const struct skin_writ
 
 	return writer;
 exit_no_task:
+exit_no_notify:
+exit_no_sender:
 exit_no_mem:
 exit_no_lock:
 	skin_service_remove(writer);
@@ -257,32 +320,44 @@ void skin_service_remove(struct skin_writer *writer)
 			|| writer->info_index >= writer->skin->kernel->max_writer_count)
 		return;
 
-	/* remove it from local book-keeping, making sure it had been added for book-keeping */
-	if (writer->index < writer->skin->writers_mem_size)
-		if (writer == writer->skin->writers[writer->index])
-			writer->skin->writers[writer->index] = NULL;
+	/* remove it from local book-keeping */
+	_unstore_writer(writer->skin, writer);
 
 	locked = skin_internal_global_write_lock(&writer->skin->kernel_locks) == 0;
 
-	/* mark it as inactive */
-	writer->skin->kernel->writers[writer->info_index].active = false;
+	/* mark it as inactive, and free its slot if no readers are attached to it */
+	skin_internal_writer_info(writer->skin, writer->info_index)->active = false;
+	skin_internal_writer_release(writer->skin, writer->info_index);
 
 	if (locked)
 		skin_internal_global_write_unlock(&writer->skin->kernel_locks);
 
-	/* stop the task */
+	/* stop the tasks */
 	writer->must_stop = 1;
 	skin_internal_wait_termination(&writer->running);
 	urt_task_delete(writer->task);
+	if (writer->notify_task)
+	{
+		skin_internal_wait_termination(&writer->notify_running);
+		urt_task_delete(writer->notify_task);
+	}
+	urt_sem_delete(writer->notify_request);
+	writer->notify_task = NULL;
+	writer->notify_request = NULL;
 
 	/* detach from locks and memory */
 	urt_shsem_detach(writer->request);
 	urt_shsem_detach(writer->response);
+	urt_shsem_detach(writer->new_frame);
 	for (b = 0; b < SKIN_CONFIG_MAX_BUFFERS; ++b)
 		urt_shrwlock_detach(writer->rwls[b]);
 	urt_shmem_detach(writer->mem);
+	urt_shmem_detach(writer->history);
+	urt_shmem_detach(writer->histograms);
 	writer->request = NULL;
 	writer->response = NULL;
+	writer->new_frame = NULL;
+	skin_internal_notify_close(writer->notify_sender);
 
 	/* call the generic clean hook */
 	if (writer->skin->writer_clean_hook)
@@ -293,7 +368,6 @@ void skin_service_remove(struct skin_writer *writer)
 		writer->callbacks.clean(writer, writer->callbacks.user_data);
 
 	/* final cleanup */
-	urt_mutex_delete(writer->stats_lock);
 	urt_mem_delete(writer);
 }
 URT_EXPORT_SYMBOL(skin_service_remove);
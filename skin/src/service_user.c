@@ -27,6 +27,8 @@
 #include "internal.h"
 #include "reader_internal.h"
 #include "names.h"
+#include "notify.h"
+#include "reader_pool.h"
 
 static int _sanity_check_skin(struct skin *skin)
 {
@@ -35,15 +37,15 @@ static int _sanity_check_skin(struct skin *skin)
 
 static struct skin_reader *_attach_reader(struct skin *skin, const char *prefix, int *error)
 {
-	unsigned int i;
-	struct skin_kernel *sk = skin->kernel;
+	uint16_t i = SKIN_KERNEL_INVALID_INDEX;
+	uint16_t s;
 	struct skin_reader *reader = NULL;
 
-	for (i = 0; i < sk->max_writer_count; ++i)
+	while ((i = skin_internal_writer_find(skin, prefix, i)) != SKIN_KERNEL_INVALID_INDEX)
 	{
-		struct skin_writer_info *w = &sk->writers[i];
+		struct skin_writer_info *w = skin_internal_writer_info(skin, i);
 
-		if (w->active && skin_internal_name_cmp_prefix(prefix, w->attr.prefix) == 0)
+		if (w->active)
 		{
 			reader = urt_mem_new(sizeof *reader, error);
 			if (reader == NULL)
@@ -51,8 +53,18 @@ static struct skin_reader *_attach_reader(struct skin *skin, const char *prefix,
 
 			++w->readers_attached;
 
+			/* take a slot for sharing statistics, if any is free */
+			for (s = 0; s < SKIN_CONFIG_MAX_READER_STATS; ++s)
+				if (!w->reader_stats[s].used)
+					break;
+			if (s < SKIN_CONFIG_MAX_READER_STATS)
+				w->reader_stats[s] = (struct skin_reader_stats_slot){
+					.used = true,
+				};
+
 			*reader = (struct skin_reader){
 				.writer_index = i,
+				.stats_slot = s,
 			};
 
 			break;
@@ -91,6 +103,13 @@ struct skin_reader *(skin_service_attach)(struct skin *skin, const struct skin_r
 	if (task_attr.soft)
 		task_attr.period = 0;
 
+	/* pull readers are read from in the caller's thread, which synchronizes with the writer like a soft reader would */
+	if (attr.pull)
+	{
+		task_attr.period = 0;
+		task_attr.soft = true;
+	}
+
 	/* default values */
 	if (!urt_priority_is_valid(task_attr.priority))
 		task_attr.priority = urt_priority(SKIN_CONFIG_PRIORITY_READER);
@@ -108,16 +127,21 @@ struct skin_reader *(skin_service_attach)(struct skin *skin, const struct skin_r
 
 	/* attach to its locks and shared memory */
 	*reader = (struct skin_reader){
-		.running = true,
-		.must_pause = true,
-		.paused = true,
+		.running = !attr.pull,
+		.must_pause = !attr.pull,
+		.paused = !attr.pull,
 		.callbacks = *callbacks,
 		.skin = skin,
 		.soft = task_attr.soft,
 		.period = task_attr.period,
+		.lossless = attr.lossless,
+		.pull = attr.pull,
+		.notify_fd = -1,
+		.notify_slot = SKIN_CONFIG_MAX_READER_NOTIFIERS,
 		.writer_index = reader->writer_index,
+		.stats_slot = reader->stats_slot,
 	};
-	writer_info = &skin->kernel->writers[reader->writer_index];
+	writer_info = skin_internal_writer_info(skin, reader->writer_index);
 	if (task_attr.period == 0 && !task_attr.soft)
 	{
 		reader->request = urt_sem_new(0, &err);
@@ -134,7 +158,14 @@ struct skin_reader *(skin_service_attach)(struct skin *skin, const struct skin_r
 		if (reader->writer_request == NULL || reader->writer_response == NULL)
 			goto exit_no_lock;
 	}
-	for (b = 0; b < writer_info->attr.buffer_count; ++b)
+	else if (task_attr.period == 0)
+	{
+		skin_internal_name_set(name, attr.name, "NEW");
+		reader->writer_new_frame = urt_shsem_attach(name, &err);
+		if (reader->writer_new_frame == NULL)
+			goto exit_no_lock;
+	}
+	for (b = 0; b < writer_info->attr.buffer_count && !writer_info->attr.lock_free; ++b)
 	{
 		skin_internal_name_set_indexed(name, attr.name, "RW", b);
 		reader->rwls[b] = urt_shrwlock_attach(name, &err);
@@ -146,6 +177,40 @@ struct skin_reader *(skin_service_attach)(struct skin *skin, const struct skin_r
 	if (reader->mem == NULL)
 		goto exit_no_mem;
 
+	/* if lossless, attach to the history of the writer, which must exist, and start from its oldest frame */
+	if (attr.lossless)
+	{
+		uint64_t frame_count = writer_info->frame_count;
+
+		err = EINVAL;
+		if (writer_info->attr.history == 0)
+			goto exit_no_history;
+		skin_internal_name_set(name, attr.name, "HST");
+		reader->history = urt_shmem_attach(name, &err);
+		if (reader->history == NULL)
+			goto exit_no_history;
+		reader->next_frame = frame_count > writer_info->attr.history?frame_count - writer_info->attr.history:0;
+	}
+
+	/* attach to the shared histograms, and start the histogram of the reader's statistics slot anew */
+	skin_internal_name_set(name, attr.name, "HSG");
+	reader->histograms = urt_shmem_attach(name, &err);
+	if (reader->histograms == NULL)
+		goto exit_no_mem;
+	if (reader->stats_slot < SKIN_CONFIG_MAX_READER_STATS)
+		reader->histograms->read_times[reader->stats_slot] = (struct skin_histogram){0};
+
+	/*
+	 * if lock-free, the reader needs a private copy of the data to make sure it is consistent.  If lossless,
+	 * it needs enough space to hold the whole history
+	 */
+	if (attr.lossless)
+		reader->copy = urt_mem_new(writer_info->attr.history * writer_info->attr.buffer_size, &err);
+	else if (writer_info->attr.lock_free)
+		reader->copy = urt_mem_new(writer_info->attr.buffer_size, &err);
+	if ((attr.lossless || writer_info->attr.lock_free) && reader->copy == NULL)
+		goto exit_no_mem;
+
 	/* cap period of periodic readers to that of writer if periodic */
 	if (writer_info->period > 0 && reader->period > 0 && reader->period < writer_info->period)
 	{
@@ -153,15 +218,31 @@ struct skin_reader *(skin_service_attach)(struct skin *skin, const struct skin_r
 		task_attr.period = reader->period;
 	}
 
-	/* create lock for stats, but failure doesn't matter */
-	reader->stats_lock = urt_mutex_new();
+	/*
+	 * a phase-locked reader keeps its own time, so that it can align its wakeups to the writer's publish instants.
+	 * Its task is therefore not periodic as far as URT is concerned
+	 */
+	reader->phase_locked = attr.phase_locked && reader->period > 0 && writer_info->period > 0;
+	if (reader->phase_locked)
+		task_attr.period = 0;
 
-	/* create the task itself */
-	reader->task = urt_task_new(skin_reader_acquisition_task, reader, &task_attr, &err);
-	if (reader->task == NULL)
-		goto exit_no_task;
-	if ((err = urt_task_start(reader->task)))
-		goto exit_no_task;
+	/*
+	 * create the task itself, unless the reader is read from in the caller's thread.  Soft readers of periodic
+	 * writers are read by the soft reader pool, if there is one and it can take the reader
+	 */
+	if (attr.pull)
+		reader->stats.start_time = urt_get_time();
+	else if (task_attr.soft && writer_info->period > 0 && skin->soft_reader_pool
+			&& skin_internal_reader_pool_add(skin->soft_reader_pool, reader) == 0)
+		reader->stats.start_time = urt_get_time();
+	else
+	{
+		reader->task = urt_task_new(skin_reader_acquisition_task, reader, &task_attr, &err);
+		if (reader->task == NULL)
+			goto exit_no_task;
+		if ((err = urt_task_start(reader->task)))
+			goto exit_no_task;
+	}
 
 	/* store the pointer in internal memory */
 	_store_reader(skin, reader);
@@ -177,6 +258,7 @@ struct skin_reader *(skin_service_attach)(struct skin *skin, const struct skin_r
 	return reader;
 exit_no_task:
 exit_no_mem:
+exit_no_history:
 exit_no_lock:
 	skin_service_detach(reader);
 exit_no_reader:
@@ -203,30 +285,51 @@ void skin_service_detach(struct skin_reader *reader)
 			|| reader->writer_index >= reader->skin->kernel->max_writer_count)
 		return;
 
-	/* remove it from local book-keeping, making sure it had been added for book-keeping */
-	if (reader->index < reader->skin->readers_mem_size)
-		if (reader == reader->skin->readers[reader->index])
-			reader->skin->readers[reader->index] = NULL;
+	/* remove it from local book-keeping, and make sure it is no longer read by a group or the soft reader pool */
+	_unstore_reader(reader->skin, reader);
+	skin_reader_leave_group(reader);
+	skin_internal_reader_pool_remove(reader);
+
+	/*
+	 * stop the task before giving up the reader's slots in writer_info, as the task still writes its statistics there,
+	 * and the writer_info itself could be released with the last reader
+	 */
+	reader->must_stop = 1;
+	skin_internal_wait_termination(&reader->running);
+	urt_task_delete(reader->task);
+
+	/* the notification descriptor is closed before its slot is freed, so a new reader taking the slot won't share it */
+	skin_internal_notify_close(reader->notify_fd);
+	reader->notify_fd = -1;
 
 	locked = skin_internal_global_write_lock(&reader->skin->kernel_locks) == 0;
 
-	/* reduce its user count */
-	--reader->skin->kernel->writers[reader->writer_index].readers_attached;
+	/* reduce its user count and free its statistics and notification slots */
+	--skin_internal_writer_info(reader->skin, reader->writer_index)->readers_attached;
+	if (reader->stats_slot < SKIN_CONFIG_MAX_READER_STATS)
+		skin_internal_writer_info(reader->skin, reader->writer_index)->reader_stats[reader->stats_slot].used = false;
+	if (reader->notify_slot < SKIN_CONFIG_MAX_READER_NOTIFIERS)
+	{
+		skin_internal_writer_info(reader->skin, reader->writer_index)->reader_notifiers[reader->notify_slot] = false;
+		--skin_internal_writer_info(reader->skin, reader->writer_index)->reader_notifier_count;
+	}
+
+	/* if it was the last reader of an inactive writer, the writer slot can be reused */
+	skin_internal_writer_release(reader->skin, reader->writer_index);
 
 	if (locked)
 		skin_internal_global_write_unlock(&reader->skin->kernel_locks);
 
-	/* stop the task */
-	reader->must_stop = 1;
-	skin_internal_wait_termination(&reader->running);
-	urt_task_delete(reader->task);
-
 	/* detach from locks and memory */
 	urt_shsem_detach(reader->writer_request);
 	urt_shsem_detach(reader->writer_response);
+	urt_shsem_detach(reader->writer_new_frame);
 	for (b = 0; b < SKIN_CONFIG_MAX_BUFFERS; ++b)
 		urt_shrwlock_detach(reader->rwls[b]);
 	urt_shmem_detach(reader->mem);
+	urt_shmem_detach(reader->history);
+	urt_shmem_detach(reader->histograms);
+	urt_mem_delete(reader->copy);
 
 	/* remove local locks */
 	urt_sem_delete(reader->request);
@@ -243,7 +346,6 @@ void skin_service_detach(struct skin_reader *reader)
 		reader->callbacks.clean(reader, reader->callbacks.user_data);
 
 	/* final cleanup */
-	urt_mutex_delete(reader->stats_lock);
 	urt_mem_delete(reader);
 }
 URT_EXPORT_SYMBOL(skin_service_detach);
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <skin_snapshot.h>
+#include "internal.h"
+
+/* make sure the snapshot arrays can hold the whole skin kernel, reallocating them if it has grown */
+static int _reserve(void **mem, size_t *mem_size, size_t count, size_t elem_size)
+{
+	void *new_mem;
+	int err = 0;
+
+	if (*mem != NULL && *mem_size >= count)
+		return 0;
+
+	new_mem = urt_mem_new(count * elem_size, &err);
+	if (new_mem == NULL)
+		return err;
+
+	urt_mem_delete(*mem);
+	*mem = new_mem;
+	*mem_size = count;
+	return 0;
+}
+
+static int _reserve_snapshot(struct skin_kernel *sk, struct skin_kernel_snapshot *snapshot)
+{
+	int err;
+
+	if ((err = _reserve((void **)&snapshot->writers, &snapshot->writers_mem_size, sk->max_writer_count,
+					sizeof *snapshot->writers)))
+		return err;
+	if ((err = _reserve((void **)&snapshot->readers, &snapshot->readers_mem_size,
+					sk->max_writer_count * SKIN_CONFIG_MAX_READER_STATS, sizeof *snapshot->readers)))
+		return err;
+	if ((err = _reserve((void **)&snapshot->drivers, &snapshot->drivers_mem_size, sk->max_driver_count,
+					sizeof *snapshot->drivers)))
+		return err;
+	return _reserve((void **)&snapshot->sensor_types, &snapshot->sensor_types_mem_size,
+			sk->max_driver_count * SKIN_CONFIG_MAX_SENSOR_TYPES, sizeof *snapshot->sensor_types);
+}
+
+static void _snapshot_writer(struct skin_kernel_snapshot *snapshot, struct skin *skin, uint16_t index)
+{
+	struct skin_writer_info *w = skin_internal_writer_info(skin, index);
+	struct skin_writer_snapshot *ws = &snapshot->writers[snapshot->writer_count++];
+	struct skin_shared_histograms *histograms;
+	uint16_t s;
+
+	*ws = (struct skin_writer_snapshot){
+		.index = index,
+		.is_driver = w->driver_index < skin->kernel->max_driver_count,
+		.driver_index = w->driver_index,
+		.active = w->active,
+		.paused = w->paused,
+		.bad = w->bad,
+		.buffer_size = w->attr.buffer_size,
+		.buffer_count = w->attr.buffer_count,
+		.lock_free = w->attr.lock_free,
+		.history = w->attr.history,
+		.period = w->period,
+		.readers_attached = w->readers_attached,
+		.frame_count = w->frame_count,
+	};
+	memcpy(ws->name, w->attr.prefix, sizeof w->attr.prefix);
+	histograms = skin_internal_attach_histograms(w);
+	skin_internal_get_writer_statistics(w, histograms, &ws->stats, &ws->write_times);
+
+	for (s = 0; s < SKIN_CONFIG_MAX_READER_STATS; ++s)
+	{
+		struct skin_reader_snapshot *rs = &snapshot->readers[snapshot->reader_count];
+
+		if (!skin_internal_get_reader_statistics(w, histograms, s, &rs->stats, &rs->read_times))
+			continue;
+
+		rs->writer_index = index;
+		rs->slot = s;
+		++snapshot->reader_count;
+	}
+
+	skin_internal_detach_histograms(histograms);
+}
+
+static void _snapshot_driver(struct skin_kernel_snapshot *snapshot, struct skin *skin, uint16_t index)
+{
+	struct skin_driver_info *d = skin_internal_driver_info(skin, index);
+	struct skin_driver_snapshot *ds = &snapshot->drivers[snapshot->driver_count++];
+	skin_sensor_type_size t;
+
+	*ds = (struct skin_driver_snapshot){
+		.index = index,
+		.writer_index = d->writer_index,
+		.active = d->active,
+		.users_attached = d->users_attached,
+		.attr = d->attr,
+		.sensor_type_count = d->sensor_type_count,
+		.sensor_types_begin = snapshot->sensor_type_count,
+	};
+
+	for (t = 0; t < d->sensor_type_count; ++t)
+		snapshot->sensor_types[snapshot->sensor_type_count++] = (struct skin_sensor_type_snapshot){
+			.driver_index = index,
+			.type = d->sensor_types[t],
+			.sensor_count = d->sensor_type_sizes[t],
+		};
+}
+
+int skin_get_kernel_snapshot(struct skin *skin, struct skin_kernel_snapshot *snapshot)
+{
+	struct skin_kernel *sk;
+	size_t i;
+	int err;
+
+	if (skin == NULL || skin->kernel == NULL || snapshot == NULL)
+		return EINVAL;
+
+	sk = skin->kernel;
+
+	if ((err = skin_internal_driver_read_lock(&skin->kernel_locks)))
+		goto exit_no_drivers_lock;
+	if ((err = skin_internal_global_read_lock(&skin->kernel_locks)))
+		goto exit_no_global_lock;
+
+	if ((err = _reserve_snapshot(sk, snapshot)))
+		goto exit_no_mem;
+
+	snapshot->time = urt_get_time();
+	snapshot->writer_count = 0;
+	snapshot->reader_count = 0;
+	snapshot->driver_count = 0;
+	snapshot->sensor_type_count = 0;
+
+	/* the writers and drivers may be in blocks created by other processes.  Slots in blocks that are not attached are free */
+	skin_internal_attach_kernel_blocks(skin);
+
+	/* the statistics are read lock-free, so the real-time tasks are never delayed by the snapshot */
+	for (i = 0; i < sk->max_writer_count; ++i)
+	{
+		struct skin_writer_info *w = skin_internal_writer_info(skin, i);
+
+		if (w && (w->active || w->readers_attached > 0))
+			_snapshot_writer(snapshot, skin, i);
+	}
+
+	for (i = 0; i < sk->max_driver_count; ++i)
+	{
+		struct skin_driver_info *d = skin_internal_driver_info(skin, i);
+
+		if (d && (d->active || d->users_attached > 0))
+			_snapshot_driver(snapshot, skin, i);
+	}
+
+exit_no_mem:
+	skin_internal_global_read_unlock(&skin->kernel_locks);
+exit_no_global_lock:
+	skin_internal_driver_read_unlock(&skin->kernel_locks);
+exit_no_drivers_lock:
+	return err;
+}
+URT_EXPORT_SYMBOL(skin_get_kernel_snapshot);
+
+void skin_kernel_snapshot_free(struct skin_kernel_snapshot *snapshot)
+{
+	if (snapshot == NULL)
+		return;
+
+	urt_mem_delete(snapshot->writers);
+	urt_mem_delete(snapshot->readers);
+	urt_mem_delete(snapshot->drivers);
+	urt_mem_delete(snapshot->sensor_types);
+	*snapshot = (struct skin_kernel_snapshot){0};
+}
+URT_EXPORT_SYMBOL(skin_kernel_snapshot_free);
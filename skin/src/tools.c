@@ -57,6 +57,54 @@ static void print_header(int name_len, int name_print_len, bool empty_before_hea
 	urt_out_cont("-+--------------+---------+--------------+---------+-----\n");
 }
 
+static uint64_t divide(uint64_t dividend, uint64_t divisor)
+{
+	if (divisor == 0)
+		return 0;
+#if !defined(__KERNEL__) || BITS_PER_LONG == 64
+	return dividend / divisor;
+#else
+	/* in kernel space, for 32 bit architectures, 64 bit division is done with do_div */
+	do_div(dividend, divisor);
+	return dividend;
+#endif
+}
+
+static void print_statistics(struct skin *skin)
+{
+	size_t i;
+	struct skin_kernel *sk = skin->kernel;
+	uint16_t s;
+
+	urt_out_cont("\n");
+	urt_out_cont(" index | reader |    frames    | avg time (ns) | worst time (ns) | swap skips |  dropped  |  missed\n");
+	urt_out_cont("-------+--------+--------------+---------------+-----------------+------------+-----------+-----------\n");
+
+	for (i = 0; i < sk->max_writer_count; ++i)
+	{
+		struct skin_writer_info *w = skin_internal_writer_info(skin, i);
+		struct skin_writer_statistics ws;
+		struct skin_reader_statistics rs;
+
+		if (w == NULL || (!w->active && w->readers_attached == 0))
+			continue;
+
+		skin_internal_get_writer_statistics(w, NULL, &ws, NULL);
+		urt_out_cont(" %5zu |        | %12llu | %13llu | %15llu | %10llu |           |\n", i,
+				(unsigned long long)ws.write_count,
+				(unsigned long long)divide(ws.accumulated_write_time, ws.write_count),
+				(unsigned long long)ws.worst_write_time, (unsigned long long)ws.swap_skips);
+
+		for (s = 0; s < SKIN_CONFIG_MAX_READER_STATS; ++s)
+			if (skin_internal_get_reader_statistics(w, NULL, s, &rs, NULL))
+				urt_out_cont("       | %6u | %12llu | %13llu | %15llu |            | %9llu | %9llu\n", s,
+						(unsigned long long)rs.read_count,
+						(unsigned long long)divide(rs.accumulated_read_time, rs.read_count),
+						(unsigned long long)rs.worst_read_time,
+						(unsigned long long)rs.frames_dropped, (unsigned long long)rs.frames_missed);
+	}
+}
+
 void skin_internal_print_info(struct skin *skin)
 {
 	size_t i;
@@ -76,16 +124,19 @@ void skin_internal_print_info(struct skin *skin)
 	if (skin_internal_global_read_lock(&skin->kernel_locks))
 		goto exit_no_global_lock;
 
+	/* the writers and drivers may be in blocks created by other processes.  Slots in blocks that are not attached are free */
+	skin_internal_attach_kernel_blocks(skin);
+
 	print_header(name_len, name_print_len, false);
 
 	/* output information on everything! */
 	for (i = 0; i < sk->max_writer_count; ++i)
 	{
-		struct skin_writer_info *w = &sk->writers[i];
+		struct skin_writer_info *w = skin_internal_writer_info(skin, i);
 		char period[20];
 		bool is_driver;
 
-		if (!w->active && w->readers_attached == 0)
+		if (w == NULL || (!w->active && w->readers_attached == 0))
 			continue;
 		if (w->period)
 			sprintf(period, "%12llu", w->period);
@@ -106,7 +157,7 @@ void skin_internal_print_info(struct skin *skin)
 
 		if (is_driver)
 		{
-			struct skin_driver_info *d = &sk->drivers[w->driver_index];
+			struct skin_driver_info *d = skin_internal_driver_info(skin, w->driver_index);
 			const char *sensor_type = NULL;
 			char sensor_type_unknown[30];
 			skin_sensor_type_id t;
@@ -135,6 +186,8 @@ void skin_internal_print_info(struct skin *skin)
 		}
 	}
 
+	print_statistics(skin);
+
 	urt_out_cont("\n");
 	urt_out_cont("Max number of drivers: %u\n", sk->max_driver_count);
 	urt_out_cont("Max number of writers: %u\n", sk->max_writer_count);
@@ -148,3 +201,159 @@ exit_no_drivers_lock:
 	urt_err("Error getting locks");
 }
 URT_EXPORT_SYMBOL(skin_internal_print_info);
+
+/* a sample of the statistics of a writer and its readers, from which watch mode calculates rates and such */
+struct watch_sample
+{
+	bool valid;
+	urt_time time;
+	struct skin_writer_statistics writer;
+	struct skin_histogram write_times;
+	bool reader_used[SKIN_CONFIG_MAX_READER_STATS];
+	struct skin_reader_statistics readers[SKIN_CONFIG_MAX_READER_STATS];
+	struct skin_histogram read_times[SKIN_CONFIG_MAX_READER_STATS];
+};
+
+static void take_sample(struct skin_writer_info *w, struct watch_sample *sample)
+{
+	struct skin_shared_histograms *histograms = skin_internal_attach_histograms(w);
+	uint16_t s;
+
+	sample->valid = true;
+	sample->time = urt_get_time();
+	skin_internal_get_writer_statistics(w, histograms, &sample->writer, &sample->write_times);
+	for (s = 0; s < SKIN_CONFIG_MAX_READER_STATS; ++s)
+		sample->reader_used[s] = skin_internal_get_reader_statistics(w, histograms, s, &sample->readers[s],
+				&sample->read_times[s]);
+	skin_internal_detach_histograms(histograms);
+}
+
+static void histogram_delta(struct skin_histogram *delta, const struct skin_histogram *cur, const struct skin_histogram *prev)
+{
+	unsigned int i;
+
+	delta->total = cur->total - (prev?prev->total:0);
+	for (i = 0; i < SKIN_HISTOGRAM_BUCKET_COUNT; ++i)
+		delta->counts[i] = cur->counts[i] - (prev?prev->counts[i]:0);
+}
+
+/*
+ * print the frame rate and execution time percentiles since the previous sample.  If there is no previous sample
+ * (for example the writer or reader is new), everything since the start of the task is taken into account.
+ */
+static void print_watch_times(uint64_t count, const struct skin_histogram *cur, const struct skin_histogram *prev,
+		struct skin_histogram *delta, urt_time elapsed)
+{
+	uint64_t rate = divide(count * 10000000000llu, elapsed);		/* in 0.1Hz */
+	uint64_t rate_int = divide(rate, 10);
+
+	histogram_delta(delta, cur, prev);
+	urt_out_cont(" %8llu.%llu | %10llu | %10llu | %10llu |",
+			(unsigned long long)rate_int, (unsigned long long)(rate - rate_int * 10),
+			(unsigned long long)skin_histogram_percentile(delta, 50000),
+			(unsigned long long)skin_histogram_percentile(delta, 99000),
+			(unsigned long long)skin_histogram_percentile(delta, 100000));
+}
+
+static void print_watch(struct skin *skin, struct watch_sample *prev, size_t prev_count, struct watch_sample *cur,
+		struct skin_histogram *delta, int name_print_len)
+{
+	size_t i;
+	uint16_t s;
+	struct skin_kernel *sk = skin->kernel;
+
+	if (skin_internal_global_read_lock(&skin->kernel_locks))
+		return;
+
+#ifndef __KERNEL__
+	/* clear the screen so the output would be refreshed in place */
+	urt_out_cont("\033[H\033[2J");
+#endif
+	urt_out_cont(" index | %*s | reader |  rate (Hz)  |  p50 (ns)  |  p99 (ns)  |  max (ns)  | swap skips |   missed   | readers | bad\n",
+			name_print_len, "name");
+
+	skin_internal_attach_kernel_blocks(skin);
+
+	for (i = 0; i < sk->max_writer_count && i < prev_count; ++i)
+	{
+		struct skin_writer_info *w = skin_internal_writer_info(skin, i);
+		struct watch_sample *p = &prev[i];
+		bool new_writer;
+
+		if (w == NULL || (!w->active && w->readers_attached == 0))
+		{
+			p->valid = false;
+			continue;
+		}
+
+		take_sample(w, cur);
+		new_writer = !p->valid || p->writer.start_time != cur->writer.start_time;
+
+		urt_out_cont(" %5zu | %*s |        |", i, name_print_len, w->attr.prefix);
+		print_watch_times(cur->writer.write_count - (new_writer?0:p->writer.write_count),
+				&cur->write_times, new_writer?NULL:&p->write_times, delta,
+				cur->time - (new_writer?cur->writer.start_time:p->time));
+		urt_out_cont(" %10llu |            | %7u | %3s\n",
+				(unsigned long long)(cur->writer.swap_skips - (new_writer?0:p->writer.swap_skips)),
+				w->readers_attached, w->bad?"Yes":"No");
+
+		for (s = 0; s < SKIN_CONFIG_MAX_READER_STATS; ++s)
+		{
+			struct skin_reader_statistics *r = &cur->readers[s];
+			bool new_reader;
+
+			if (!cur->reader_used[s] || r->start_time == 0)
+				continue;
+
+			new_reader = new_writer || !p->reader_used[s] || p->readers[s].start_time != r->start_time;
+
+			urt_out_cont("       | %*s | %6u |", name_print_len, "", s);
+			print_watch_times(r->read_count - (new_reader?0:p->readers[s].read_count),
+					&cur->read_times[s], new_reader?NULL:&p->read_times[s], delta,
+					cur->time - (new_reader?r->start_time:p->time));
+			urt_out_cont("            | %10llu |         |\n",
+					(unsigned long long)(r->frames_missed - (new_reader?0:p->readers[s].frames_missed)));
+		}
+
+		*p = *cur;
+	}
+
+	skin_internal_global_read_unlock(&skin->kernel_locks);
+}
+
+void skin_internal_watch_info(struct skin *skin, unsigned int interval, volatile sig_atomic_t *stop)
+{
+	size_t i;
+	size_t count = 0;
+	struct watch_sample *samples = NULL;
+	struct skin_histogram *delta = NULL;
+	int name_len = URT_NAME_LEN - 3;
+	int name_print_len = name_len < 4?4:name_len;
+	int err;
+
+	while (!*stop)
+	{
+		/* one sample per writer from the previous round, one for the current sample and a scratch histogram */
+		if (count < skin->kernel->max_writer_count)
+		{
+			urt_mem_delete(samples);
+			count = skin->kernel->max_writer_count;
+			samples = urt_mem_new((count + 1) * sizeof *samples + sizeof *delta, &err);
+			if (samples == NULL)
+			{
+				urt_err("Out of memory\n");
+				return;
+			}
+			delta = (struct skin_histogram *)&samples[count + 1];
+
+			for (i = 0; i < count; ++i)
+				samples[i].valid = false;
+		}
+
+		print_watch(skin, samples, count, &samples[count], delta, name_print_len);
+		urt_sleep(interval * 1000000llu);
+	}
+
+	urt_mem_delete(samples);
+}
+URT_EXPORT_SYMBOL(skin_internal_watch_info);
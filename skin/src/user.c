@@ -44,50 +44,64 @@ static int _sanity_check_user(struct skin_user *user)
 		|| user->driver_index >= user->skin->kernel->max_driver_count?-1:0;
 }
 
+unsigned int skin_internal_local_users_of_driver(struct skin *skin, uint16_t driver_index)
+{
+	return driver_index < skin->driver_users_mem_size?skin->driver_users[driver_index]:0;
+}
+
+static void _count_local_user(struct skin *skin, uint16_t driver_index)
+{
+	void *enlarged;
+	size_t new_size;
+
+	if (driver_index >= skin->driver_users_mem_size)
+	{
+		new_size = skin->kernel->max_driver_count;
+		if (new_size <= driver_index)
+			new_size = driver_index + 1;
+		enlarged = urt_mem_resize(skin->driver_users,
+				skin->driver_users_mem_size * sizeof *skin->driver_users,
+				new_size * sizeof *skin->driver_users);
+		if (enlarged == NULL)
+		{
+			urt_err("out of memory keeping track of attached drivers; driver %u may be attached to again\n", driver_index);
+			return;
+		}
+		skin->driver_users = enlarged;
+		memset(skin->driver_users + skin->driver_users_mem_size, 0,
+				(new_size - skin->driver_users_mem_size) * sizeof *skin->driver_users);
+		skin->driver_users_mem_size = new_size;
+	}
+
+	++skin->driver_users[driver_index];
+}
+
+static void _uncount_local_user(struct skin *skin, uint16_t driver_index)
+{
+	if (driver_index < skin->driver_users_mem_size && skin->driver_users[driver_index] > 0)
+		--skin->driver_users[driver_index];
+}
+
 static int _find_driver_by_sensor_type(struct skin *skin, char *reader_prefix, skin_sensor_type_id sensor_type, int *error)
 {
-	unsigned int i, j, k;
-	struct skin_kernel *sk = skin->kernel;
+	uint16_t i;
+	uint32_t node = SKIN_KERNEL_INVALID_NODE;
 	int ret = -1;
-	bool found = false;
 
 	if ((*error = skin_internal_driver_read_lock(&skin->kernel_locks)))
 		goto exit_no_drivers_lock;
 
-	for (i = 0; i < sk->max_driver_count && !found; ++i)
+	while ((i = skin_internal_driver_find_by_type(skin, sensor_type, &node)) != SKIN_KERNEL_INVALID_INDEX)
 	{
-		struct skin_driver_info *d = &sk->drivers[i];
+		struct skin_driver_info *d = skin_internal_driver_info(skin, i);
 
-		if (!d->active)
+		/* skip inactive drivers and make sure we aren't already attached to this driver */
+		if (!d->active || skin_internal_local_users_of_driver(skin, i) > 0)
 			continue;
 
-		for (j = 0; j < d->sensor_type_count; ++j)
-			if (d->sensor_types[j] == sensor_type)
-			{
-				struct skin_writer_info *w = &sk->writers[d->writer_index];
-				bool exists = false;
-
-				/* make sure we aren't already attached to this driver */
-				for (k = 0; k < skin->users_mem_size; ++k)
-					if (skin->users[k] != NULL)
-					{
-						struct skin_writer_info *uw = &sk->writers[skin->users[k]->reader->writer_index];
-
-						if (skin_internal_name_cmp_prefix(w->attr.prefix, uw->attr.prefix) == 0)
-						{
-							exists = true;
-							break;
-						}
-					}
-
-				if (!exists)
-				{
-					skin_internal_name_cpy_prefix(reader_prefix, w->attr.prefix);
-					found = true;
-					ret = 0;
-					break;
-				}
-			}
+		skin_internal_name_cpy_prefix(reader_prefix, skin_internal_writer_info(skin, d->writer_index)->attr.prefix);
+		ret = 0;
+		break;
 	}
 
 	if (ret)
@@ -100,51 +114,83 @@ exit_no_drivers_lock:
 
 static struct skin_user *_attach_user(struct skin *skin, const struct skin_user_attr *attr, const struct skin_reader *reader, int *error)
 {
-	unsigned int i;
+	uint16_t i;
 	struct skin_kernel *sk = skin->kernel;
 	struct skin_user *user = NULL;
-	struct skin_writer_info *writer_info = &sk->writers[reader->writer_index];
+	struct skin_writer_info *writer_info = skin_internal_writer_info(skin, reader->writer_index);
+	struct skin_driver_info *d;
 	char name[URT_NAME_LEN + 1];
 
-	for (i = 0; i < sk->max_driver_count; ++i)
+	/* the writer knows its driver, if any */
+	i = writer_info->driver_index;
+	d = i < sk->max_driver_count?skin_internal_driver_info(skin, i):NULL;
+	if (d == NULL || !d->used || d->writer_index != reader->writer_index)
 	{
-		struct skin_driver_info *d = &sk->drivers[i];
+		*error = ENOENT;
+		return NULL;
+	}
 
-		if (d->writer_index == reader->writer_index)
-		{
-			/* attach to the data structure memory of the driver */
-			skin_internal_name_set(name, writer_info->attr.prefix, "DS");
-			SKIN_DEFINE_STRUCTURE(d->attr);
-			skin_structure *ds = urt_shmem_attach(name, error);
-			if (ds == NULL)
-				goto exit_fail;
-
-			user = urt_mem_new(sizeof *user, error);
-			if (user == NULL)
-			{
-				urt_shmem_detach(ds);
-				goto exit_fail;
-			}
-
-			++d->users_attached;
-
-			*user = (struct skin_user){
-				.driver_attr = d->attr,
-				.data_structure = ds,
-				.driver_index = i,
-			};
+	/* attach to the data structure memory of the driver */
+	skin_internal_name_set(name, writer_info->attr.prefix, "DS");
+	SKIN_DEFINE_STRUCTURE(d->attr);
+	skin_structure *ds = urt_shmem_attach(name, error);
+	if (ds == NULL)
+		goto exit_fail;
 
-			break;
-		}
+	user = urt_mem_new(sizeof *user, error);
+	if (user == NULL)
+	{
+		urt_shmem_detach(ds);
+		goto exit_fail;
 	}
 
-	if (user == NULL)
-		*error = ENOENT;
+	++d->users_attached;
+
+	*user = (struct skin_user){
+		.driver_attr = d->attr,
+		.data_structure = ds,
+		.driver_index = i,
+	};
 
 exit_fail:
 	return user;
 }
 
+/* each array in a user's arena starts on its own cache line */
+#define ARENA_ALIGNMENT 64
+/* per-sensor extra data is padded so that any basic type could be stored at its start */
+#define SENSOR_DATA_ALIGNMENT 16
+
+static size_t _align_size(size_t size, size_t alignment)
+{
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/*
+ * reserve a section for count elements of given size at the end of the arena, returning its offset.  If the arena
+ * size overflows, *overflow is set, and the returned offset is meaningless
+ */
+static size_t _arena_reserve(size_t *arena_size, size_t count, size_t size, bool *overflow)
+{
+	size_t offset;
+
+	/* leave room for aligning the beginning of the arena too */
+	if (*arena_size > SIZE_MAX - 2 * (ARENA_ALIGNMENT - 1))
+		goto exit_overflow;
+	offset = _align_size(*arena_size, ARENA_ALIGNMENT);
+
+	if (size > 0 && count > SIZE_MAX / size)
+		goto exit_overflow;
+	if (count * size > SIZE_MAX - (ARENA_ALIGNMENT - 1) - offset)
+		goto exit_overflow;
+
+	*arena_size = offset + count * size;
+	return offset;
+exit_overflow:
+	*overflow = true;
+	return 0;
+}
+
 static int _construct_structure(struct skin_user *user)
 {
 	int err;
@@ -153,15 +199,51 @@ static int _construct_structure(struct skin_user *user)
 	skin_sensor_id s;
 	skin_module_size m_so_far;
 	skin_sensor_size s_so_far;
+	size_t arena_size = 0;
+	bool overflow = false;
+	size_t patches_offset, modules_offset, sensors_offset, responses_offset;
+	size_t type_responses_offset, type_sensors_offset, sensor_data_offset;
+	char *arena;
 	SKIN_DEFINE_STRUCTURE(user->driver_attr);
 	skin_structure *ds = user->data_structure;
 
-	user->patches = urt_mem_new(user->driver_attr.patch_count * sizeof *user->patches, &err);
-	user->modules = urt_mem_new(user->driver_attr.module_count * sizeof *user->modules, &err);
-	user->sensors = urt_mem_new(user->driver_attr.sensor_count * sizeof *user->sensors, &err);
-
-	if (user->patches == NULL || user->modules == NULL || user->sensors == NULL)
-		goto exit_no_mem;
+	/*
+	 * All arrays are laid out in a single allocation.  This avoids fragmentation and many small
+	 * allocations when there are many users, and keeps the structure of each user close in memory.
+	 */
+	if (user->sensor_data_size > SIZE_MAX - (SENSOR_DATA_ALIGNMENT - 1))
+		return ENOMEM;
+	user->sensor_data_size = _align_size(user->sensor_data_size, SENSOR_DATA_ALIGNMENT);
+
+	patches_offset = _arena_reserve(&arena_size, user->driver_attr.patch_count, sizeof *user->patches, &overflow);
+	modules_offset = _arena_reserve(&arena_size, user->driver_attr.module_count, sizeof *user->modules, &overflow);
+	sensors_offset = _arena_reserve(&arena_size, user->driver_attr.sensor_count, sizeof *user->sensors, &overflow);
+	responses_offset = _arena_reserve(&arena_size, user->driver_attr.sensor_count, sizeof *user->responses,
+			&overflow);
+	type_responses_offset = _arena_reserve(&arena_size, user->driver_attr.sensor_count,
+			sizeof *user->type_responses, &overflow);
+	type_sensors_offset = _arena_reserve(&arena_size, user->driver_attr.sensor_count, sizeof *user->type_sensors,
+			&overflow);
+	sensor_data_offset = _arena_reserve(&arena_size, user->driver_attr.sensor_count, user->sensor_data_size,
+			&overflow);
+	if (overflow)
+		return ENOMEM;
+
+	/* allocate a bit extra to be able to align the beginning of the arena */
+	user->arena = urt_mem_new(arena_size + ARENA_ALIGNMENT - 1, &err);
+	if (user->arena == NULL)
+		return err;
+
+	arena = (char *)(((uintptr_t)user->arena + ARENA_ALIGNMENT - 1) & ~(uintptr_t)(ARENA_ALIGNMENT - 1));
+	memset(arena, 0, arena_size);
+
+	user->patches = (void *)(arena + patches_offset);
+	user->modules = (void *)(arena + modules_offset);
+	user->sensors = (void *)(arena + sensors_offset);
+	user->responses = (void *)(arena + responses_offset);
+	user->type_responses = (void *)(arena + type_responses_offset);
+	user->type_sensors = (void *)(arena + type_sensors_offset);
+	user->sensor_data = user->sensor_data_size?arena + sensor_data_offset:NULL;
 
 	/* initialize sensors */
 	for (s = 0; s < user->driver_attr.sensor_count; ++s)
@@ -172,6 +254,7 @@ static int _construct_structure(struct skin_user *user)
 			/* .module is filled later */
 			.type = ds->sensors[s].type,
 			.user = user,
+			.user_data = user->sensor_data?(char *)user->sensor_data + s * user->sensor_data_size:NULL,
 		};
 	}
 
@@ -211,61 +294,269 @@ static int _construct_structure(struct skin_user *user)
 	}
 
 	return 0;
-exit_no_mem:
-	urt_mem_delete(user->patches);
-	urt_mem_delete(user->modules);
-	urt_mem_delete(user->sensors);
-	return err;
+}
+
+static skin_sensor_type_id _sensor_type_index(struct skin_user *user, skin_sensor_type_id type)
+{
+	skin_sensor_type_id i;
+
+	for (i = 0; i < user->sensor_type_count; ++i)
+		if (user->sensor_types[i].type == type)
+			break;
+
+	return i;
 }
 
 static void _build_sensor_type_indices(struct skin_user *user, struct skin_driver_info *driver_info)
 {
 	skin_sensor_id s;
 	skin_sensor_type_id i;
-	skin_sensor_type_id last_sensor_of_type[SKIN_CONFIG_MAX_SENSOR_TYPES];
+	skin_sensor_size next_of_type[SKIN_CONFIG_MAX_SENSOR_TYPES];
 
-	/* mark all as invalid */
 	user->sensor_type_count = driver_info->sensor_type_count;
 	for (i = 0; i < user->sensor_type_count; ++i)
 	{
 		user->sensor_types[i].type = driver_info->sensor_types[i];
-		user->sensor_types[i].first_sensor = SKIN_INVALID_ID;
-		last_sensor_of_type[i] = SKIN_INVALID_ID;
+		user->sensor_types[i].sensor_count = 0;
 	}
 
-	/* find the first of each sensor type */
+	/* count the sensors of each type */
 	for (s = 0; s < user->driver_attr.sensor_count; ++s)
 	{
-		struct skin_sensor *sensor = &user->sensors[s];
-
-		for (i = 0; i < user->sensor_type_count; ++i)
-			if (user->sensor_types[i].type == sensor->type)
-				break;
-
+		i = _sensor_type_index(user, user->sensors[s].type);
 		if (i >= user->sensor_type_count)
 		{
 			internal_error("user detected sensor type (%u) that was undetected by driver ('%s')\n",
-					sensor->type, user->skin->kernel->writers[driver_info->writer_index].attr.prefix);
+					user->sensors[s].type,
+					skin_internal_writer_info(user->skin, driver_info->writer_index)->attr.prefix);
 			continue;
 		}
 
-		/* if not already set, this is the first of this type */
-		if (user->sensor_types[i].first_sensor >= user->driver_attr.sensor_count)
-			user->sensor_types[i].first_sensor = s;
-		/* otherwise, there was a sensor before this, so set that sensor's next to this sensor */
-		else
-			user->sensors[last_sensor_of_type[i]].next_of_type = s;
+		++user->sensor_types[i].sensor_count;
+	}
+
+	/* lay out the sensors of each sensor type one after the other */
+	for (i = 0, s = 0; i < user->sensor_type_count; ++i)
+	{
+		user->sensor_types[i].first_of_type = s;
+		next_of_type[i] = s;
+		s += user->sensor_types[i].sensor_count;
+	}
 
-		last_sensor_of_type[i] = s;
+	/* fill in the sensor indices of each type, in order of sensor ids */
+	for (s = 0; s < user->driver_attr.sensor_count; ++s)
+	{
+		i = _sensor_type_index(user, user->sensors[s].type);
+		if (i < user->sensor_type_count)
+			user->type_sensors[next_of_type[i]++] = s;
 	}
+}
+
+static bool _sensor_type_covers_user(struct skin_user *user, skin_sensor_type_id i)
+{
+	/* if all sensors are of this type, their responses are already contiguous */
+	return user->sensor_types[i].sensor_count == user->driver_attr.sensor_count;
+}
+
+/*
+ * update the copy of responses grouped by type, for the types whose responses have been requested as a span.  This is
+ * done by the reader, right after the responses are updated, so the copy is never written by other threads
+ */
+static void _group_responses_by_type(struct skin_user *user)
+{
+	skin_sensor_type_id i;
+	skin_sensor_id s;
 
-	/* set the next of the last visited sensor types to invalid */
 	for (i = 0; i < user->sensor_type_count; ++i)
-		if (last_sensor_of_type[i] < user->driver_attr.sensor_count)
-			user->sensors[last_sensor_of_type[i]].next_of_type = SKIN_INVALID_ID;
+	{
+		skin_sensor_size first = user->sensor_types[i].first_of_type;
+		skin_sensor_size count = user->sensor_types[i].sensor_count;
+
+		if (!user->sensor_types[i].grouping_requested)
+			continue;
+
+		for (s = first; s < first + count; ++s)
+			user->type_responses[s] = user->responses[user->type_sensors[s]];
+	}
 }
 
-SKIN_DEFINE_STORE_FUNCTION(user);
+/*
+ * The batch hooks get all the sensors, modules or patches of the user at once.  The per-object hooks are
+ * called after the batch hooks on init and before them on clean.
+ */
+static void _call_structure_init_hooks(struct skin *skin, struct skin_user *user)
+{
+	skin_patch_id p;
+	skin_module_id m;
+	skin_sensor_id s;
+
+	if (skin->sensor_batch_init_hook)
+		skin->sensor_batch_init_hook(user->sensors, user->driver_attr.sensor_count, skin->sensor_batch_init_user_data);
+	if (skin->sensor_init_hook)
+		for (s = 0; s < user->driver_attr.sensor_count; ++s)
+			skin->sensor_init_hook(&user->sensors[s], skin->sensor_init_user_data);
+	if (skin->module_batch_init_hook)
+		skin->module_batch_init_hook(user->modules, user->driver_attr.module_count, skin->module_batch_init_user_data);
+	if (skin->module_init_hook)
+		for (m = 0; m < user->driver_attr.module_count; ++m)
+			skin->module_init_hook(&user->modules[m], skin->module_init_user_data);
+	if (skin->patch_batch_init_hook)
+		skin->patch_batch_init_hook(user->patches, user->driver_attr.patch_count, skin->patch_batch_init_user_data);
+	if (skin->patch_init_hook)
+		for (p = 0; p < user->driver_attr.patch_count; ++p)
+			skin->patch_init_hook(&user->patches[p], skin->patch_init_user_data);
+}
+
+static void _call_structure_clean_hooks(struct skin *skin, struct skin_user *user)
+{
+	skin_patch_id p;
+	skin_module_id m;
+	skin_sensor_id s;
+
+	/* if the structure was never constructed, there is nothing to clean */
+	if (user->arena == NULL)
+		return;
+
+	if (skin->patch_clean_hook)
+		for (p = 0; p < user->driver_attr.patch_count; ++p)
+			skin->patch_clean_hook(&user->patches[p], skin->patch_clean_user_data);
+	if (skin->patch_batch_clean_hook)
+		skin->patch_batch_clean_hook(user->patches, user->driver_attr.patch_count, skin->patch_batch_clean_user_data);
+	if (skin->module_clean_hook)
+		for (m = 0; m < user->driver_attr.module_count; ++m)
+			skin->module_clean_hook(&user->modules[m], skin->module_clean_user_data);
+	if (skin->module_batch_clean_hook)
+		skin->module_batch_clean_hook(user->modules, user->driver_attr.module_count, skin->module_batch_clean_user_data);
+	if (skin->sensor_clean_hook)
+		for (s = 0; s < user->driver_attr.sensor_count; ++s)
+			skin->sensor_clean_hook(&user->sensors[s], skin->sensor_clean_user_data);
+	if (skin->sensor_batch_clean_hook)
+		skin->sensor_batch_clean_hook(user->sensors, user->driver_attr.sensor_count, skin->sensor_batch_clean_user_data);
+}
+
+SKIN_DEFINE_ORDERED_STORE_FUNCTION(user);
+
+static void _add_sensor_type(struct skin *skin, struct skin_user *user, skin_sensor_type_id type)
+{
+	skin_sensor_type_size i;
+	void *enlarged;
+	size_t new_size;
+
+	/* note: the number of distinct sensor types is small */
+	for (i = 0; i < skin->sensor_type_count; ++i)
+		if (skin->sensor_types[i].type == type)
+		{
+			++skin->sensor_types[i].user_count;
+			return;
+		}
+
+	if (skin->sensor_type_count >= skin->sensor_types_mem_size)
+	{
+		new_size = skin->sensor_types_mem_size?2 * skin->sensor_types_mem_size:SKIN_CONFIG_MAX_SENSOR_TYPES;
+		enlarged = urt_mem_resize(skin->sensor_types,
+				skin->sensor_types_mem_size * sizeof *skin->sensor_types,
+				new_size * sizeof *skin->sensor_types);
+		if (enlarged == NULL)
+		{
+			urt_err("out of memory keeping track of sensor types; sensor type %u will be missing\n", type);
+			return;
+		}
+		skin->sensor_types = enlarged;
+		skin->sensor_types_mem_size = new_size;
+	}
+
+	skin->sensor_types[skin->sensor_type_count++] = (struct skin_sensor_type_entry){
+		.type = type,
+		.user = user,
+		.user_count = 1,
+	};
+}
+
+static bool _user_has_sensor_type(struct skin_user *user, skin_sensor_type_id type)
+{
+	skin_sensor_type_size t;
+
+	for (t = 0; t < user->sensor_type_count; ++t)
+		if (user->sensor_types[t].type == type)
+			return true;
+	return false;
+}
+
+/*
+ * take a type out of the distinct sensor types, as a user with sensors of that type is being detached.  The user is
+ * still stored.  If other users have sensors of this type, the entry stays, but if it refers to this user, the next
+ * user with sensors of this type is looked for
+ */
+static void _remove_sensor_type(struct skin *skin, struct skin_user *user, skin_sensor_type_id type)
+{
+	skin_sensor_type_size i;
+	size_t u;
+
+	for (i = 0; i < skin->sensor_type_count; ++i)
+		if (skin->sensor_types[i].type == type)
+			break;
+	/* if it was missing due to lack of memory */
+	if (i == skin->sensor_type_count)
+		return;
+
+	if (--skin->sensor_types[i].user_count == 0)
+	{
+		/* keep the order of the rest of the types */
+		for (; i + 1 < skin->sensor_type_count; ++i)
+			skin->sensor_types[i] = skin->sensor_types[i + 1];
+		--skin->sensor_type_count;
+		return;
+	}
+
+	if (skin->sensor_types[i].user != user)
+		return;
+
+	for (u = user->index + 1; u < skin->user_count; ++u)
+		if (_user_has_sensor_type(skin->users[u], type))
+		{
+			skin->sensor_types[i].user = skin->users[u];
+			break;
+		}
+}
+
+/*
+ * update the skin-wide information on sensors, which is needed whenever a user is attached or detached.  This
+ * information includes the total count of sensors, modules and patches, the offset of each user's sensors among all
+ * sensors and the list of distinct sensor types.  Rather than recalculating this information over all users, only
+ * the contribution of the user being attached or detached is added or taken out.
+ *
+ * _add_user_sensor_info must be called after the user is stored at the end of the users, and
+ * _remove_user_sensor_info must be called while the user is still stored.
+ */
+static void _add_user_sensor_info(struct skin *skin, struct skin_user *user)
+{
+	skin_sensor_type_size t;
+
+	user->sensor_offset = skin->sensor_count;
+	skin->sensor_count += user->driver_attr.sensor_count;
+	skin->module_count += user->driver_attr.module_count;
+	skin->patch_count += user->driver_attr.patch_count;
+
+	for (t = 0; t < user->sensor_type_count; ++t)
+		_add_sensor_type(skin, user, user->sensor_types[t].type);
+}
+
+static void _remove_user_sensor_info(struct skin *skin, struct skin_user *user)
+{
+	skin_sensor_type_size t;
+	size_t i;
+
+	skin->sensor_count -= user->driver_attr.sensor_count;
+	skin->module_count -= user->driver_attr.module_count;
+	skin->patch_count -= user->driver_attr.patch_count;
+
+	/* the sensors of the users after this one move back */
+	for (i = user->index + 1; i < skin->user_count; ++i)
+		skin->users[i]->sensor_offset -= user->driver_attr.sensor_count;
+
+	for (t = 0; t < user->sensor_type_count; ++t)
+		_remove_sensor_type(skin, user, user->sensor_types[t].type);
+}
 
 static void _copy_sensor_responses(struct skin_user *user, skin_sensor_response *responses,
 		skin_sensor_size sensor_count, void *user_data)
@@ -276,14 +567,27 @@ static void _copy_sensor_responses(struct skin_user *user, skin_sensor_response
 if (sensor_count != user->driver_attr.sensor_count)
 urt_err("internal error: mismatch between acq sensor count and creation-time sensor count\n");
 
-	for (s = 0; s < sensor_count; ++s)
-		user->sensors[s].response = responses[s];
+	/* the responses are kept contiguous, so this is a single sequential copy */
+	memcpy(user->responses, responses, sensor_count * sizeof *responses);
+	if (user->grouping_requested)
+		_group_responses_by_type(user);
+
+	/* unless the user only wants the contiguous responses, the sensors get their own copy too */
+	if (!user->contiguous_responses)
+		for (s = 0; s < sensor_count; ++s)
+			user->sensors[s].response = responses[s];
 }
 
 static void _user_reader_callback(struct skin_reader *reader, void *mem, size_t size, void *user_data)
 {
 	struct skin_user *user = user_data;
-	user->callbacks.peek(user, mem, user->driver_attr.sensor_count, user->callbacks.user_data);
+	size_t frame_size = user->driver_attr.sensor_count * sizeof(skin_sensor_response);
+	size_t offset;
+
+	/* if lossless, there may be more than one frame to peek at */
+	for (offset = 0; offset + frame_size <= size; offset += frame_size)
+		user->callbacks.peek(user, (skin_sensor_response *)((char *)mem + offset),
+				user->driver_attr.sensor_count, user->callbacks.user_data);
 }
 
 static void _user_reader_init(struct skin_reader *reader, void *user_data)
@@ -306,9 +610,6 @@ struct skin_user *(skin_driver_attach)(struct skin *skin, const struct skin_user
 	struct skin_reader *reader = NULL;
 	char reader_prefix[URT_NAME_LEN - 3 + 1];
 	int err = 0;
-	skin_patch_id p;
-	skin_module_id m;
-	skin_sensor_id s;
 	struct skin_user_attr attr;
 	struct skin_reader_attr reader_attr;
 	struct urt_task_attr task_attr;
@@ -377,6 +678,8 @@ struct skin_user *(skin_driver_attach)(struct skin *skin, const struct skin_user
 	if (user == NULL)
 		goto exit_no_user;
 
+	_count_local_user(skin, user->driver_index);
+
 	*user = (struct skin_user){
 		.callbacks = callbacks,
 		.driver_attr = user->driver_attr,
@@ -384,6 +687,8 @@ struct skin_user *(skin_driver_attach)(struct skin *skin, const struct skin_user
 		.skin = skin,
 		.reader = reader,
 		.driver_index = user->driver_index,
+		.sensor_data_size = attr.sensor_data_size,
+		.contiguous_responses = attr.contiguous_responses,
 	};
 	reader->user = user;
 
@@ -395,10 +700,12 @@ struct skin_user *(skin_driver_attach)(struct skin *skin, const struct skin_user
 		goto exit_no_structure;
 
 	/* build sensor type indices */
-	_build_sensor_type_indices(user, &skin->kernel->drivers[user->driver_index]);
+	_build_sensor_type_indices(user, skin_internal_driver_info(skin, user->driver_index));
 
 	/* store the pointer in internal memory */
 	_store_user(skin, user);
+	if (SKIN_IS_STORED_(user))
+		_add_user_sensor_info(skin, user);
 
 	/* call the object-specific init hooks */
 	if (callbacks.init)
@@ -407,15 +714,7 @@ struct skin_user *(skin_driver_attach)(struct skin *skin, const struct skin_user
 	/* call the generic init hooks */
 	if (skin->user_init_hook)
 		skin->user_init_hook(user, skin->user_init_user_data);
-	if (skin->sensor_init_hook)
-		for (s = 0; s < user->driver_attr.sensor_count; ++s)
-			skin->sensor_init_hook(&user->sensors[s], skin->sensor_init_user_data);
-	if (skin->module_init_hook)
-		for (m = 0; m < user->driver_attr.module_count; ++m)
-			skin->module_init_hook(&user->modules[m], skin->module_init_user_data);
-	if (skin->patch_init_hook)
-		for (p = 0; p < user->driver_attr.patch_count; ++p)
-			skin->patch_init_hook(&user->patches[p], skin->patch_init_user_data);
+	_call_structure_init_hooks(skin, user);
 
 	return user;
 exit_no_structure:
@@ -444,23 +743,24 @@ URT_EXPORT_SYMBOL(skin_driver_attach);
 
 void skin_driver_detach(struct skin_user *user)
 {
+	struct skin *skin;
 	bool locked;
-	skin_patch_id p;
-	skin_module_id m;
-	skin_sensor_id s;
 
 	if (user == NULL || _sanity_check_skin(user->skin) || _sanity_check_user(user))
 		return;
+	skin = user->skin;
 
-	/* remove it from local book-keeping, making sure it had been added for book-keeping */
-	if (user->index < user->skin->users_mem_size)
-		if (user == user->skin->users[user->index])
-			user->skin->users[user->index] = NULL;
+	/* remove it from local book-keeping */
+	if (SKIN_IS_STORED_(user))
+		_remove_user_sensor_info(skin, user);
+	_unstore_user(skin, user);
+	_uncount_local_user(user->skin, user->driver_index);
 
 	locked = skin_internal_driver_write_lock(&user->skin->kernel_locks) == 0;
 
-	/* reduce its user count */
-	--user->skin->kernel->drivers[user->driver_index].users_attached;
+	/* reduce its user count, and free the driver slot if it was the last user of an inactive driver */
+	--skin_internal_driver_info(user->skin, user->driver_index)->users_attached;
+	skin_internal_driver_release(user->skin, user->driver_index);
 
 	if (locked)
 		skin_internal_driver_write_unlock(&user->skin->kernel_locks);
@@ -475,24 +775,14 @@ void skin_driver_detach(struct skin_user *user)
 	/* call the generic clean hooks */
 	if (user->skin->user_clean_hook)
 		user->skin->user_clean_hook(user, user->skin->user_clean_user_data);
-	if (user->skin->patch_clean_hook)
-		for (p = 0; p < user->driver_attr.patch_count; ++p)
-			user->skin->patch_clean_hook(&user->patches[p], user->skin->patch_clean_user_data);
-	if (user->skin->module_clean_hook)
-		for (m = 0; m < user->driver_attr.module_count; ++m)
-			user->skin->module_clean_hook(&user->modules[m], user->skin->module_clean_user_data);
-	if (user->skin->sensor_clean_hook)
-		for (s = 0; s < user->driver_attr.sensor_count; ++s)
-			user->skin->sensor_clean_hook(&user->sensors[s], user->skin->sensor_clean_user_data);
+	_call_structure_clean_hooks(user->skin, user);
 
 	/* call the object-specific clean hooks */
 	if (user->callbacks.clean)
 		user->callbacks.clean(user, user->callbacks.user_data);
 
 	/* final cleanup */
-	urt_mem_delete(user->patches);
-	urt_mem_delete(user->modules);
-	urt_mem_delete(user->sensors);
+	urt_mem_delete(user->arena);
 	urt_mem_delete(user);
 }
 URT_EXPORT_SYMBOL(skin_driver_detach);
@@ -514,12 +804,87 @@ struct skin_reader *skin_user_get_reader(struct skin_user *user)
 }
 URT_EXPORT_SYMBOL(skin_user_get_reader);
 
+const skin_sensor_response *skin_user_get_responses(struct skin_user *user)
+{
+	if (_sanity_check_user(user))
+		return NULL;
+	return user->responses;
+}
+URT_EXPORT_SYMBOL(skin_user_get_responses);
+
+struct skin_response_span skin_user_get_response_span(struct skin_user *user)
+{
+	if (_sanity_check_user(user))
+		return (struct skin_response_span){0};
+
+	return (struct skin_response_span){
+		.responses = user->responses,
+		.count = user->driver_attr.sensor_count,
+		.stride = 1,
+	};
+}
+URT_EXPORT_SYMBOL(skin_user_get_response_span);
+
+struct skin_response_span skin_user_get_response_span_of_type(struct skin_user *user, skin_sensor_type_id type)
+{
+	skin_sensor_type_id i;
+
+	if (_sanity_check_user(user))
+		return (struct skin_response_span){0};
+
+	i = _sensor_type_index(user, type);
+	if (i >= user->sensor_type_count || user->sensor_types[i].sensor_count == 0)
+		return (struct skin_response_span){0};
+
+	/*
+	 * let the reader know it should keep the responses of this type grouped from now on.  These flags are only
+	 * ever set, so there is no need to synchronize with the reader
+	 */
+	if (!_sensor_type_covers_user(user, i))
+	{
+		user->sensor_types[i].grouping_requested = true;
+		user->grouping_requested = true;
+	}
+
+	return (struct skin_response_span){
+		.responses = _sensor_type_covers_user(user, i)?user->responses
+			:user->type_responses + user->sensor_types[i].first_of_type,
+		.count = user->sensor_types[i].sensor_count,
+		.stride = 1,
+	};
+}
+URT_EXPORT_SYMBOL(skin_user_get_response_span_of_type);
+
+const skin_sensor_id *skin_user_get_sensors_of_type(struct skin_user *user, skin_sensor_type_id type,
+		skin_sensor_size *count)
+{
+	skin_sensor_type_id i;
+
+	if (_sanity_check_user(user))
+		return NULL;
+
+	i = _sensor_type_index(user, type);
+	if (i >= user->sensor_type_count)
+		return NULL;
+
+	if (count)
+		*count = user->sensor_types[i].sensor_count;
+	return user->type_sensors + user->sensor_types[i].first_of_type;
+}
+URT_EXPORT_SYMBOL(skin_user_get_sensors_of_type);
+
 skin_sensor_size skin_user_sensor_count(struct skin_user *user)
 {
 	return user->driver_attr.sensor_count;
 }
 URT_EXPORT_SYMBOL(skin_user_sensor_count);
 
+skin_sensor_size skin_user_sensor_offset(struct skin_user *user)
+{
+	return user->sensor_offset;
+}
+URT_EXPORT_SYMBOL(skin_user_sensor_offset);
+
 skin_module_size skin_user_module_count(struct skin_user *user)
 {
 	return user->driver_attr.module_count;
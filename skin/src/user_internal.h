@@ -44,11 +44,13 @@ struct skin_user
 	struct
 	{
 		skin_sensor_type_id type;
-		skin_sensor_id first_sensor;
+		skin_sensor_size sensor_count;
+		skin_sensor_size first_of_type;
+		bool grouping_requested;	/* whether responses of this type have been requested as a span */
 	} sensor_types[SKIN_CONFIG_MAX_SENSOR_TYPES];
 						/*
-						 * an array of sensor types that also tells what is the index
-						 * of the first sensor of each type.
+						 * an array of sensor types that also tells how many sensors are
+						 * of each type and where they start in type_sensors and type_responses.
 						 */
 	void *data_structure;			/*
 						 * the data structure of the piece of skin handled
@@ -57,11 +59,29 @@ struct skin_user
 	struct skin_patch *patches;		/* built from the basic data structure taken from the driver, ... */
 	struct skin_module *modules;		/* the complete data structure with internal references and ... */
 	struct skin_sensor *sensors;		/* computed information ready to be used are stored here ... */
+	skin_sensor_response *responses;	/*
+						 * the sensor responses, indexed by sensor id.  These are kept
+						 * apart from the sensors so they could be processed in bulk
+						 */
+	skin_sensor_id *type_sensors;		/* the sensor ids, grouped by sensor type */
+	skin_sensor_response *type_responses;	/*
+						 * the sensor responses, grouped by sensor type.  These are only
+						 * updated for types whose responses are requested as a span
+						 */
+	bool grouping_requested;		/* whether responses of any type have been requested as a span */
+	void *sensor_data;			/* per-sensor extra data, sensor_data_size bytes each */
+	size_t sensor_data_size;		/* size of sensor_data of each sensor, padded for alignment */
+	bool contiguous_responses;		/* whether responses are only kept in the responses array */
+	void *arena;				/*
+						 * the single allocation holding all of the above arrays, each
+						 * starting on a cache line
+						 */
 	/* references */
 	struct skin *skin;			/* reference back to the skin object */
 	struct skin_reader *reader;		/* the reader of the user */
 	uint16_t driver_index;			/* index to driver_info in skin kernel */
 	uint16_t index;				/* index to skin's list of users */
+	skin_sensor_size sensor_offset;		/* index of the first sensor of this user among all sensors */
 	/* bookkeeping */
 	bool mark_for_removal;			/* helper flag for skin_update */
 };
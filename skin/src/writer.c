@@ -25,6 +25,7 @@
 #define URT_LOG_PREFIX "skin: "
 #include <skin_writer.h>
 #include "internal.h"
+#include "notify.h"
 
 static int _sanity_check_writer(struct skin_writer *writer, bool is_sporadic)
 {
@@ -32,6 +33,75 @@ static int _sanity_check_writer(struct skin_writer *writer, bool is_sporadic)
 		|| (is_sporadic && (writer->request == NULL || writer->response == NULL))?-1:0;
 }
 
+/*
+ * notify the readers that wait for new frames on a file descriptor.  Sending a notification is a system call per
+ * reader, which doesn't belong in the real-time task of the writer.  Instead, the writer task only rings a doorbell,
+ * posting a semaphore to the notify task, which sends the notifications to all readers.  The semaphore is posted only
+ * once until the notify task takes it, so frames published while notifications are being sent coalesce into one
+ * more round of notifications, which is all the readers need to know there is new data
+ */
+static void _notify_readers(struct skin_writer *writer, struct skin_writer_info *info)
+{
+	if (writer->notify_request == NULL || info->reader_notifier_count == 0)
+		return;
+
+	if (skin_internal_atomic_xchg(&writer->notify_pending, 1) == 0)
+		urt_sem_post(writer->notify_request);
+}
+
+static void _send_notifications(struct skin_writer *writer, struct skin_writer_info *info)
+{
+	unsigned int i;
+	unsigned int remaining = info->reader_notifier_count;
+
+	for (i = 0; i < SKIN_CONFIG_MAX_READER_NOTIFIERS && remaining > 0; ++i)
+	{
+		if (!info->reader_notifiers[i])
+			continue;
+		skin_internal_notify_send(writer->notify_sender, info->attr.prefix, i);
+		--remaining;
+	}
+}
+
+void skin_internal_writer_notify_task(urt_task *task, void *data)
+{
+	struct skin_writer *writer = data;
+	struct skin_writer_info *writer_info = skin_internal_writer_info(writer->skin, writer->info_index);
+
+	while (!writer->must_stop)
+	{
+		if (urt_sem_wait(writer->notify_request, &writer->must_stop))
+			continue;
+
+		/* take the doorbell before sending, so a frame published in the meantime would ring it again */
+		skin_internal_atomic_xchg(&writer->notify_pending, 0);
+		_send_notifications(writer, writer_info);
+	}
+
+	writer->notify_running = false;
+}
+
+/*
+ * wake up all readers that are waiting for a new frame, posting once for each registration.  A reader that registers
+ * itself late would be woken up next time.  Readers that stop waiting without being woken take back their registration
+ */
+static void _signal_new_frame(struct skin_writer *writer, struct skin_writer_info *info)
+{
+	unsigned int waiters;
+
+	skin_internal_seq_write_begin(&info->publish_seq);
+	info->last_publish_time = urt_get_time();
+	skin_internal_seq_write_end(&info->publish_seq);
+	_notify_readers(writer, info);
+
+	if (writer->new_frame == NULL)
+		return;
+
+	waiters = skin_internal_atomic_xchg(&info->new_frame_waiters, 0);
+	while (waiters-- > 0)
+		urt_sem_post(writer->new_frame);
+}
+
 static bool _swap_buffers(struct skin_writer *writer, struct skin_writer_info *info, uint8_t *cur_buf, urt_time wait_time, bool before_write)
 {
 	uint8_t i;
@@ -67,7 +137,9 @@ static bool _swap_buffers(struct skin_writer *writer, struct skin_writer_info *i
 			info->buffer_being_written = next_buf;
 			info->next_predicted_swap = next_swap;
 			info->last_written_buffer = *cur_buf;
+			info->publish_times[*cur_buf] = urt_get_time();
 			urt_rwlock_write_unlock(writer->rwls[*cur_buf]);
+			_signal_new_frame(writer, info);
 
 			*cur_buf = next_buf;
 			return true;
@@ -76,6 +148,84 @@ static bool _swap_buffers(struct skin_writer *writer, struct skin_writer_info *i
 	return false;
 }
 
+/*
+ * the time given to one swap attempt.  A swap attempt waits on each of the other buffers in turn, so there is no point
+ * in waiting on a buffer longer than readers are observed to hold it; with a shorter wait, the writer can go around
+ * the buffers again and catch the one that is released first.  If readers haven't reported their hold times yet,
+ * the whole budget is given to the attempt.
+ */
+static inline urt_time _swap_attempt_time(struct skin_writer_info *info, urt_time budget)
+{
+	urt_time hold_time = info->reader_hold_time;
+
+	return hold_time > 0 && hold_time < budget?hold_time:budget;
+}
+
+/* copy the buffer just written to the history ring, protecting it with the sequence counter of the ring frame */
+static void _record_history(struct skin_writer *writer, struct skin_writer_info *info, uint8_t cur_buf, urt_time timestamp)
+{
+	uint64_t frame = info->frame_count;
+	struct skin_history_frame *hf = skin_internal_history_frame(writer->history, &info->attr, frame);
+
+	/* make the sequence odd, so readers would know the frame is being overwritten */
+	++hf->seq;
+	skin_internal_write_barrier();
+
+	memcpy(hf->data, (char *)writer->mem + cur_buf * info->attr.buffer_size, info->attr.buffer_size);
+	hf->frame = frame;
+	hf->write_time = timestamp;
+	/* the frame becomes visible to readers as soon as it is counted, right after this */
+	hf->publish_time = urt_get_time();
+
+	/* make the sequence even again, so readers would know the frame is consistent */
+	skin_internal_write_barrier();
+	++hf->seq;
+}
+
+/*
+ * copy the statistics to shared memory, so other processes could monitor them.  The execution time of the cycle is
+ * recorded in the shared histogram too, unless 0 which means no cycle has been executed
+ */
+static void _publish_statistics(struct skin_writer *writer, struct skin_writer_info *info, urt_time exec_time)
+{
+	skin_internal_seq_write_begin(&info->stats_seq);
+	info->stats = writer->stats;
+	if (exec_time)
+		skin_histogram_record(&writer->histograms->write_time, exec_time);
+	skin_internal_seq_write_end(&info->stats_seq);
+}
+
+static inline void _begin_lock_free_write(struct skin_writer_info *info, uint8_t cur_buf)
+{
+	/* make the sequence odd, so readers would know the buffer is being written */
+	++info->seqs[cur_buf];
+	skin_internal_write_barrier();
+}
+
+static uint8_t _end_lock_free_write(struct skin_writer_info *info, uint8_t cur_buf)
+{
+	uint8_t next_buf = (cur_buf + 1) % info->attr.buffer_count;
+
+	/*
+	 * make the sequence even again, so readers would know the buffer is consistent, and only then publish it.  The
+	 * publish time is set while the sequence is still odd, so readers would see it together with the data
+	 */
+	info->publish_times[cur_buf] = urt_get_time();
+	skin_internal_write_barrier();
+	++info->seqs[cur_buf];
+	skin_internal_write_barrier();
+
+	/*
+	 * the next buffer to write to is the oldest one.  A reader still reading it would notice the change of
+	 * sequence and retry with the latest buffer
+	 */
+	info->last_written_buffer = cur_buf;
+	info->buffer_being_written = next_buf;
+	info->next_predicted_swap = urt_get_time() + info->period;
+
+	return next_buf;
+}
+
 /*
  * the synchronization mechanism in the writer is as follows:
  *
@@ -105,7 +255,21 @@ static bool _swap_buffers(struct skin_writer *writer, struct skin_writer_info *i
  *		}				}
  *		unlock(cur)			unlock(cur)
  *
- * In the function, the specific code that belongs to either of these four cases is marked as such.
+ * Lock-free	5. loop {			6. loop {
+ *							wait request
+ *			seq(cur)++ (odd)		seq(cur)++ (odd)
+ *			func				func
+ *			seq(cur)++ (even)		seq(cur)++ (even)
+ *			last = cur			last = cur
+ *			cur = next			cur = next
+ *							respond
+ *			wait period
+ *		}				}
+ *
+ * In the lock-free cases, the writer never waits for the readers.  Instead, the readers take a copy of the last
+ * buffer and check whether its sequence has changed in the meantime, in which case they retry.
+ *
+ * In the function, the specific code that belongs to either of these six cases is marked as such.
  */
 void skin_writer_acquisition_task(urt_task *task, void *data)
 {
@@ -115,15 +279,21 @@ void skin_writer_acquisition_task(urt_task *task, void *data)
 	urt_time timestamp = 0;
 	bool multi_buffer;
 	bool periodic;
+	bool lock_free;
 	bool swap_done = true;
+	urt_time swap_budget = 0;
 
 	if (_sanity_check_writer(writer, false))
 		goto exit_bad_argument;
-	writer_info = &writer->skin->kernel->writers[writer->info_index];
+	writer_info = skin_internal_writer_info(writer->skin, writer->info_index);
 
 	current_buffer = writer_info->buffer_being_written;
+	skin_internal_seq_write_begin(&writer->stats_seq);
 	writer->stats.start_time = urt_get_time();
-	multi_buffer = writer_info->attr.buffer_count > 1;
+	skin_internal_seq_write_end(&writer->stats_seq);
+	_publish_statistics(writer, writer_info, 0);
+	lock_free = writer_info->attr.lock_free;
+	multi_buffer = writer_info->attr.buffer_count > 1 && !lock_free;
 	periodic = writer_info->period > 0;
 
 	/* check more if sporadic */
@@ -134,15 +304,16 @@ void skin_writer_acquisition_task(urt_task *task, void *data)
 	if (multi_buffer)
 		urt_rwlock_write_lock(writer->rwls[current_buffer], &writer->must_stop);
 
-	urt_dbg(writer->skin->log_file, "writer %u started (period: %lld) (name: %s)\n", writer->info_index, writer_info->period,
-			writer_info->attr.prefix);
+	urt_dbg(writer->skin->log_file, "writer %u started (period: %lld, lock-free: %s) (name: %s)\n", writer->info_index,
+			writer_info->period, lock_free?"Yes":"No", writer_info->attr.prefix);
 
 	while (!writer->must_stop)
 	{
 		urt_time exec_time = urt_get_exec_time(), passed_time = urt_get_time();
 		bool must_pause;
-		bool locked;
 		bool swap_skipped = false;
+		unsigned int swaps = 0;
+		bool written = false;
 
 		/* cases 3 and 4: if multi-buffer, try swapping buffers if not yet done */
 		if (multi_buffer)
@@ -151,6 +322,8 @@ void skin_writer_acquisition_task(urt_task *task, void *data)
 				swap_done = _swap_buffers(writer, writer_info, &current_buffer, 0, true);
 				if (!swap_done)
 					swap_skipped = true;
+				else
+					++swaps;
 			}
 
 		/* if paused, sleep and retry */
@@ -160,16 +333,20 @@ void skin_writer_acquisition_task(urt_task *task, void *data)
 		if (must_pause)
 			goto skip_write;
 
-		/* cases 2 and 4: wait for request for sporadic writes */
+		/* cases 2, 4 and 6: wait for request for sporadic writes */
 		if (!periodic)
 			if (urt_sem_wait(writer->request, &writer->must_stop))
 				goto skip_write;
 
 		/* cases 1 and 2: if single-buffer, lock the buffer */
-		if (!multi_buffer)
+		if (!multi_buffer && !lock_free)
 			if (urt_rwlock_write_lock(writer->rwls[0], &writer->must_stop))
 				goto skip_write;
 
+		/* cases 5 and 6: if lock-free, mark the buffer as being written */
+		if (lock_free)
+			_begin_lock_free_write(writer_info, current_buffer);
+
 		/* call the writer callback with the current buffer */
 		timestamp = urt_get_time();
 		writer_info->bad = writer->callbacks.write(writer,
@@ -177,27 +354,70 @@ void skin_writer_acquisition_task(urt_task *task, void *data)
 				writer_info->attr.buffer_size,
 				writer->callbacks.user_data);
 		writer_info->write_times[current_buffer] = timestamp;
+		writer_info->frame_numbers[current_buffer] = writer_info->frame_count;
+		written = true;
 
-		if (multi_buffer)
+		/* if there is history, record the frame there too, and only then count it, which makes it visible in history */
+		if (writer->history)
+			_record_history(writer, writer_info, current_buffer, timestamp);
+		skin_internal_write_barrier();
+		++writer_info->frame_count;
+
+		/* cases 5 and 6: if lock-free, publish the buffer and move on to the next one */
+		if (lock_free)
+		{
+			current_buffer = _end_lock_free_write(writer_info, current_buffer);
+			_signal_new_frame(writer, writer_info);
+		}
+		else if (multi_buffer)
 		{
+			/* case 3: if periodic, the swap budget is what is left of the period after the write */
+			urt_time deadline = periodic?urt_task_next_period(task):0;
+			urt_time now = urt_get_time();
+
+			swap_budget = periodic?(deadline > now?deadline - now:0):SKIN_CONFIG_EVENT_MAX_DELAY;
+
+			/*
+			 * let the estimate of reader hold times decay, so a single long read doesn't affect the writer forever.
+			 * Once negligible compared to the swap budget, forget it altogether so the budget isn't wasted on many
+			 * tiny attempts
+			 */
+			writer_info->reader_hold_time -= writer_info->reader_hold_time >> 4;
+			if (writer_info->reader_hold_time < ((periodic?writer_info->period:SKIN_CONFIG_EVENT_MAX_DELAY) >> 6))
+				writer_info->reader_hold_time = 0;
+
 			swap_done = false;
 			while (!swap_done && !writer->must_stop)
 			{
+				urt_time budget = swap_budget;
+
 				/* case 3: if periodic, then try swapping buffers only until period expires */
 				/* case 4: if sporadic, try this forever */
-				if (periodic && urt_get_time() < 200000)
-					/* if not enough time left, wait period and try swapping in new period */
-					break;
-
-				swap_done = _swap_buffers(writer, writer_info, &current_buffer, 200000, false);
+				if (periodic)
+				{
+					now = urt_get_time();
+					if (now >= deadline)
+						/* if no time left, wait period and try swapping in new period */
+						break;
+					budget = deadline - now;
+				}
+
+				swap_done = _swap_buffers(writer, writer_info, &current_buffer,
+						_swap_attempt_time(writer_info, budget), false);
 			}
+			if (swap_done)
+				++swaps;
 		}
 		else
+		{
 			/* cases 1 and 2: unlock the buffer */
+			writer_info->publish_times[0] = urt_get_time();
 			urt_rwlock_write_unlock(writer->rwls[0]);
+			_signal_new_frame(writer, writer_info);
+		}
 
 		/* statistics */
-		locked = urt_mutex_lock(writer->stats_lock, &writer->must_stop) == 0;
+		skin_internal_seq_write_begin(&writer->stats_seq);
 
 		++writer->stats.write_count;
 		exec_time = urt_get_exec_time() - exec_time;
@@ -210,20 +430,28 @@ void skin_writer_acquisition_task(urt_task *task, void *data)
 		if (exec_time < writer->stats.best_write_time || writer->stats.best_write_time == 0)
 			writer->stats.best_write_time = exec_time;
 		writer->stats.accumulated_write_time += exec_time;
+		skin_histogram_record(&writer->write_time_histogram, exec_time);
 		if (swap_skipped)
 			++writer->stats.swap_skips;
+		writer->stats.swap_count += swaps;
+		if (multi_buffer)
+			writer->stats.swap_budget = swap_budget;
 
-		if (locked)
-			urt_mutex_unlock(writer->stats_lock);
+		skin_internal_seq_write_end(&writer->stats_seq);
+		_publish_statistics(writer, writer_info, exec_time);
 
-		/* cases 2 and 4: if sporadic, signal your requesters that write has been done */
+		/* cases 2, 4 and 6: if sporadic, signal your requesters that write has been done */
 		if (!periodic)
 			skin_internal_signal_all_requests(writer->request, writer->response);
 skip_write:
-		/* cases 1 and 3: if periodic, wait your period */
+		/* cases 1, 3 and 5: if periodic, wait your period */
 		if (periodic)
 			urt_task_wait_period(task);
-		else
+		/*
+		 * cases 2, 4 and 6: if sporadic, waiting for request already blocks, so only sleep if paused or the wait
+		 * has failed, to avoid a busy loop
+		 */
+		else if (!written)
 			urt_sleep(SKIN_CONFIG_EVENT_MAX_DELAY);
 	}
 
@@ -330,11 +558,13 @@ int skin_writer_get_attr(struct skin_writer *writer, struct skin_writer_attr *at
 	if ((err = skin_internal_global_read_lock(&writer->skin->kernel_locks)))
 		return err;
 
-	attr_internal = &writer->skin->kernel->writers[writer->info_index].attr;
+	attr_internal = &skin_internal_writer_info(writer->skin, writer->info_index)->attr;
 	*attr = (struct skin_writer_attr){
 		.buffer_size = attr_internal->buffer_size,
 		.buffer_count = attr_internal->buffer_count,
 		.name = attr_internal->prefix,
+		.lock_free = attr_internal->lock_free,
+		.history = attr_internal->history,
 	};
 
 	skin_internal_global_read_unlock(&writer->skin->kernel_locks);
@@ -345,28 +575,38 @@ URT_EXPORT_SYMBOL(skin_writer_get_attr);
 
 int skin_writer_get_statistics(struct skin_writer *writer, struct skin_writer_statistics *stats)
 {
-	bool locked = false;
+	uint32_t seq;
 
 	if (_sanity_check_writer(writer, false) || stats == NULL)
 		return EINVAL;
 
-	/*
-	 * if calling from real-time context, locking is possible.  Otherwise,
-	 * even if task is running, synchronization is impossible.  However,
-	 * if not in real-time context, it is likely that this function is being
-	 * called from cleanup hook.
-	 */
-	if (urt_is_rt_context())
-		locked = urt_mutex_lock(writer->stats_lock, &writer->must_stop) == 0;
+	/* the writer task never waits for this copy, so take it again if the task has updated the statistics meanwhile */
+	do
+	{
+		seq = skin_internal_seq_read_begin(&writer->stats_seq);
+		*stats = writer->stats;
+	} while (skin_internal_seq_read_retry(&writer->stats_seq, seq));
 
-	*stats = writer->stats;
+	return 0;
+}
+URT_EXPORT_SYMBOL(skin_writer_get_statistics);
 
-	if (locked)
-		urt_mutex_unlock(writer->stats_lock);
+int skin_writer_get_histogram(struct skin_writer *writer, struct skin_histogram *hist)
+{
+	uint32_t seq;
+
+	if (_sanity_check_writer(writer, false) || hist == NULL)
+		return EINVAL;
+
+	do
+	{
+		seq = skin_internal_seq_read_begin(&writer->stats_seq);
+		*hist = writer->write_time_histogram;
+	} while (skin_internal_seq_read_retry(&writer->stats_seq, seq));
 
 	return 0;
 }
-URT_EXPORT_SYMBOL(skin_writer_get_statistics);
+URT_EXPORT_SYMBOL(skin_writer_get_histogram);
 
 void skin_writer_copy_last_buffer(struct skin_writer *writer)
 {
@@ -376,7 +616,7 @@ void skin_writer_copy_last_buffer(struct skin_writer *writer)
 	if (_sanity_check_writer(writer, false) || writer->mem == NULL)
 		return;
 
-	writer_info = &writer->skin->kernel->writers[writer->info_index];
+	writer_info = skin_internal_writer_info(writer->skin, writer->info_index);
 	last = (char *)writer->mem + writer_info->last_written_buffer * writer_info->attr.buffer_size;
 	cur = (char *)writer->mem + writer_info->buffer_being_written * writer_info->attr.buffer_size;
 
@@ -26,6 +26,7 @@
 #define WRITER_INTERNAL_H
 
 #include <skin_writer.h>
+#include <skin_reader.h>
 #include "config.h"
 
 struct skin_driver;
@@ -34,9 +35,32 @@ struct skin_writer_attr_internal
 {
 	size_t buffer_size;
 	uint8_t buffer_count;
+	bool lock_free;
+	uint32_t history;
 	char prefix[URT_NAME_LEN - 3 + 1];
 };
 
+/* statistics of a reader, shared with other processes for monitoring */
+struct skin_reader_stats_slot
+{
+	bool used;				/* whether a reader has taken this slot */
+	uint32_t seq;				/* sequence counter of stats, odd while being updated */
+	struct skin_reader_statistics stats;
+};
+
+/*
+ * histograms of execution times of a writer and its readers, shared with other processes for monitoring.  These are
+ * kept in a shared memory of each writer ("HSG") rather than in writer_info, so that the skin kernel doesn't grow by
+ * them for every writer slot, whether used or not.  The sequence counters of the statistics in writer_info protect
+ * them as well.
+ */
+struct skin_shared_histograms
+{
+	struct skin_histogram write_time;	/* protected by stats_seq of writer_info */
+	struct skin_histogram read_times[SKIN_CONFIG_MAX_READER_STATS];
+						/* protected by seq of each reader statistics slot */
+};
+
 /* data shared with readers */
 struct skin_writer_info
 {
@@ -52,13 +76,65 @@ struct skin_writer_info
 	/* synchronization */
 	urt_time write_times[SKIN_CONFIG_MAX_BUFFERS];
 						/* last write time on each buffer */
+	uint64_t frame_numbers[SKIN_CONFIG_MAX_BUFFERS];
+						/* frame number of the data in each buffer */
+	urt_time publish_times[SKIN_CONFIG_MAX_BUFFERS];
+						/* when each buffer was last made available to readers */
+	uint32_t seqs[SKIN_CONFIG_MAX_BUFFERS];
+						/* sequence counter of each buffer, odd while being written (if lock-free) */
 	uint8_t last_written_buffer;		/* the buffer with the latest data */
 	uint8_t buffer_being_written;		/* the buffer currently being filled */
 	bool active;				/* whether writer is active */
+	bool used;				/* whether the slot is in use (active or with readers still attached) */
+	uint16_t next;				/*
+						 * next writer with the same prefix hash if used,
+						 * otherwise the next free writer
+						 */
 	bool paused;				/* whether writer is paused */
 	urt_time next_predicted_swap;		/* when the next swap is expected to happen */
+	uint32_t publish_seq;			/* sequence counter of last_publish_time, odd while being updated */
+	urt_time last_publish_time;		/* when the last frame was made available to readers */
+	urt_time reader_hold_time;		/* recent worst time readers have held a buffer, decayed by the writer */
+	unsigned int new_frame_waiters;		/* number of readers waiting for a new frame (if periodic) */
+	uint64_t frame_count;			/* number of frames written since creation */
+	/* statistics, shared with other processes for monitoring */
+	uint32_t stats_seq;			/* sequence counter of stats, odd while being updated */
+	struct skin_writer_statistics stats;
+	struct skin_reader_stats_slot reader_stats[SKIN_CONFIG_MAX_READER_STATS];
+						/* statistics of attached readers */
+	bool reader_notifiers[SKIN_CONFIG_MAX_READER_NOTIFIERS];
+						/* which readers are to be notified of new frames through a file descriptor */
+	uint16_t reader_notifier_count;		/* number of used slots in reader_notifiers */
 };
 
+/* a frame in the history ring of a writer, followed by the frame data */
+struct skin_history_frame
+{
+	uint32_t seq;				/* sequence counter, odd while being written */
+	uint64_t frame;				/* the frame number of the data */
+	urt_time write_time;			/* the time the data was written */
+	urt_time publish_time;			/* the time the data was made available to readers */
+	uint8_t data[];
+};
+
+static inline size_t skin_internal_history_frame_size(struct skin_writer_attr_internal *attr)
+{
+	/* keep frame headers aligned */
+	return sizeof(struct skin_history_frame) + ((attr->buffer_size + 7) & ~(size_t)7);
+}
+
+static inline struct skin_history_frame *skin_internal_history_frame(void *history,
+		struct skin_writer_attr_internal *attr, uint64_t frame)
+{
+#if !defined(__KERNEL__) || BITS_PER_LONG == 64
+	uint32_t index = frame % attr->history;
+#else
+	/* in kernel space, for 32 bit architectures, 64 bit division is done with do_div */
+	uint32_t index = do_div(frame, attr->history);
+#endif
+	return (struct skin_history_frame *)((char *)history + index * skin_internal_history_frame_size(attr));
+}
+
 /* internal information on writers */
 struct skin_writer
 {
@@ -70,10 +146,19 @@ struct skin_writer
 	urt_task *task;				/* the real-time task for this writer */
 	/* synchronization */
 	urt_rwlock *rwls[SKIN_CONFIG_MAX_BUFFERS];
-						/* rwlocks for synchronization */
+						/* rwlocks for synchronization (if not lock-free) */
 	urt_sem *request,			/* request and response */
 		*response;			/* semaphores for sporadic tasks */
+	urt_sem *new_frame;			/* semaphore to wake up readers waiting for new data (if periodic) */
+	int notify_sender;			/* descriptor to notify readers with, or -1 if not supported */
+	urt_task *notify_task;			/* the non-real-time task notifying readers (if notify_sender) */
+	bool notify_running;			/* if true, notify task is not yet terminated */
+	urt_sem *notify_request;		/* posted by the writer task to have the readers notified */
+	unsigned int notify_pending;		/* whether notify_request is posted and not yet taken */
 	void *mem;				/* shared memory for writer */
+	void *history;				/* shared memory for history ring (if history) */
+	struct skin_shared_histograms *histograms;
+						/* shared memory for histograms of the writer and its readers */
 	/* acquisition */
 	struct skin_writer_callbacks callbacks;
 	/* references */
@@ -83,7 +168,11 @@ struct skin_writer
 	uint16_t index;				/* index to skin's list of writers */
 	/* statistics */
 	struct skin_writer_statistics stats;
-	urt_mutex *stats_lock;
+	struct skin_histogram write_time_histogram;
+	uint32_t stats_seq;			/* sequence counter of statistics, odd while they are being updated */
 };
 
+/* the task sending notifications to readers on behalf of the real-time task of the writer */
+void skin_internal_writer_notify_task(urt_task *task, void *data);
+
 #endif
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define URT_LOG_PREFIX "skin_bench: "
+#include <string.h>
+#include <skin.h>
+
+URT_MODULE_LICENSE("GPL");
+URT_MODULE_AUTHOR("Shahbaz Youssefi");
+URT_MODULE_DESCRIPTION("Skin Service Benchmark");
+
+/*
+ * This benchmark runs a service writer with a number of readers attached to it, once with the usual
+ * rwlock-protected buffers and once with lock-free buffer publication.  The writer stamps each buffer
+ * with the time it was written and the readers measure how old the data they read is.  At the end,
+ * the swap skips of the writer and the read counts and data latency of the readers are reported.
+ */
+static unsigned int readers = 4;
+static unsigned int buffers = 2;
+static unsigned int buffer_size = 4096;
+static unsigned int writer_period = 1000;
+static unsigned int reader_period = 1000;
+static unsigned int duration = 5;
+
+URT_MODULE_PARAM_START()
+URT_MODULE_PARAM(readers, uint, "Number of readers.  Default value is 4")
+URT_MODULE_PARAM(buffers, uint, "Number of writer buffers.  Default value is 2")
+URT_MODULE_PARAM(buffer_size, uint, "Size of each buffer.  Default value is 4096")
+URT_MODULE_PARAM(writer_period, uint, "Writer period in microseconds.  Default value is 1000 (1ms)")
+URT_MODULE_PARAM(reader_period, uint, "Reader period in microseconds (0 for soft).  Default value is 1000 (1ms)")
+URT_MODULE_PARAM(duration, uint, "Duration of each run in seconds.  Default value is 5")
+URT_MODULE_PARAM_END()
+
+#define MAX_READERS 16
+
+struct reader_data
+{
+	urt_time worst_latency;
+	urt_time accumulated_latency;
+	uint64_t read_count;
+};
+
+struct data
+{
+	struct skin *skin;
+	struct reader_data reader_data[MAX_READERS];
+};
+
+static int start(struct data *d);
+static void body(struct data *d);
+static void stop(struct data *d);
+
+URT_GLUE(start, body, stop, struct data, interrupted, done)
+
+static int write_time(struct skin_writer *writer, void *mem, size_t size, void *user_data)
+{
+	urt_time t = urt_get_time();
+
+	memset(mem, 0, size);
+	memcpy(mem, &t, sizeof t);
+
+	return 0;
+}
+
+static void read_time(struct skin_reader *reader, void *mem, size_t size, void *user_data)
+{
+	struct reader_data *rd = user_data;
+	urt_time written;
+	urt_time latency;
+
+	memcpy(&written, mem, sizeof written);
+	if (written == 0)
+		return;
+
+	latency = urt_get_time() - written;
+	if (latency > rd->worst_latency)
+		rd->worst_latency = latency;
+	rd->accumulated_latency += latency;
+	++rd->read_count;
+}
+
+static void cleanup(struct data *d)
+{
+	skin_free(d->skin);
+	urt_exit();
+}
+
+static int start(struct data *d)
+{
+	*d = (struct data){0};
+
+	if (readers > MAX_READERS)
+		readers = MAX_READERS;
+	if (buffer_size < sizeof(urt_time))
+		buffer_size = sizeof(urt_time);
+
+	if (urt_init())
+		return EXIT_FAILURE;
+
+	d->skin = skin_init();
+	if (d->skin == NULL)
+		goto exit_no_skin;
+
+	return 0;
+exit_no_skin:
+	urt_err("init failed\n");
+	cleanup(d);
+	return EXIT_FAILURE;
+}
+
+static void run(struct data *d, bool lock_free)
+{
+	struct skin_writer *writer;
+	struct skin_reader *reader[MAX_READERS] = {NULL};
+	struct skin_writer_statistics wstats;
+	unsigned int i;
+	int err;
+
+	memset(d->reader_data, 0, sizeof d->reader_data);
+
+	writer = skin_service_add(d->skin, &(struct skin_writer_attr){
+				.buffer_size = buffer_size,
+				.buffer_count = buffers,
+				.name = "BNC",
+				.lock_free = lock_free,
+			}, &(urt_task_attr){
+				.period = writer_period * 1000llu,
+				.priority = urt_priority(2),
+			}, &(struct skin_writer_callbacks){
+				.write = write_time,
+			}, &err);
+	if (writer == NULL)
+	{
+		urt_err("could not add benchmark service (error: %d)\n", err);
+		return;
+	}
+
+	for (i = 0; i < readers; ++i)
+	{
+		reader[i] = skin_service_attach(d->skin, &(struct skin_reader_attr){
+					.name = "BNC",
+				}, &(urt_task_attr){
+					.period = reader_period * 1000llu,
+					.soft = reader_period == 0,
+					.priority = urt_priority(3),
+				}, &(struct skin_reader_callbacks){
+					.read = read_time,
+					.user_data = &d->reader_data[i],
+				}, &err);
+		if (reader[i] == NULL)
+		{
+			urt_err("could not attach to benchmark service (error: %d)\n", err);
+			goto exit_no_reader;
+		}
+	}
+
+	skin_writer_resume(writer);
+	for (i = 0; i < readers; ++i)
+		skin_reader_resume(reader[i]);
+
+	for (i = 0; i < duration * 10 && !interrupted; ++i)
+		urt_sleep(100000000);
+
+	for (i = 0; i < readers; ++i)
+		skin_reader_pause(reader[i]);
+	skin_writer_pause(writer);
+
+	skin_writer_get_statistics(writer, &wstats);
+
+	urt_out("%s:\n", lock_free?"lock-free":"rwlock");
+	urt_out("  writer: %llu writes, %llu swaps, %llu swap skips\n", (unsigned long long)wstats.write_count,
+			(unsigned long long)wstats.swap_count, (unsigned long long)wstats.swap_skips);
+	for (i = 0; i < readers; ++i)
+	{
+		struct reader_data *rd = &d->reader_data[i];
+
+		urt_out("  reader %u: %llu reads, latency avg: %llu ns, worst: %llu ns\n", i,
+				(unsigned long long)rd->read_count,
+				(unsigned long long)(rd->read_count?rd->accumulated_latency / rd->read_count:0),
+				(unsigned long long)rd->worst_latency);
+	}
+
+exit_no_reader:
+	for (i = 0; i < readers; ++i)
+		if (reader[i])
+			skin_service_detach(reader[i]);
+	skin_service_remove(writer);
+}
+
+static void body(struct data *d)
+{
+	urt_out("%u readers, %u buffers of %u bytes, writer period: %u us, reader period: %u us\n",
+			readers, buffers, buffer_size, writer_period, reader_period);
+
+	run(d, false);
+	if (!interrupted)
+		run(d, true);
+
+	done = 1;
+}
+
+static void stop(struct data *d)
+{
+	cleanup(d);
+}
@@ -0,0 +1,349 @@
+/*
+ * Copyright (C) 2011-2015  Maclab, DIBRIS, Universita di Genova <info@cyskin.com>
+ * Authored by Shahbaz Youssefi <ShabbyX@gmail.com>
+ *
+ * The research leading to these results has received funding from
+ * the European Commission's Seventh Framework Programme (FP7) under
+ * Grant Agreement n. 231500 (ROBOSKIN).
+ *
+ * This file is part of Skinware.
+ *
+ * Skinware is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Skinware is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Skinware.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define URT_LOG_PREFIX "skin_responses_bench: "
+#include <skin.h>
+#include <skin_responses.h>
+
+URT_MODULE_LICENSE("GPL");
+URT_MODULE_AUTHOR("Shahbaz Youssefi");
+URT_MODULE_DESCRIPTION("Skin Response Operations Benchmark");
+
+/*
+ * This benchmark runs the bulk response operations of skin_responses.h over an array of random responses, once
+ * with each implementation supported by the processor.  The average time per call and the throughput of each
+ * operation are reported.
+ *
+ * Before benchmarking, every implementation supported by the processor is checked against the scalar one on random
+ * responses of various lengths, including lengths that are not a multiple of any vector width.  If any result
+ * differs, the benchmark fails.
+ */
+static unsigned int sensors = 4096;
+static unsigned int iterations = 10000;
+
+URT_MODULE_PARAM_START()
+URT_MODULE_PARAM(sensors, uint, "Number of sensor responses.  Default value is 4096")
+URT_MODULE_PARAM(iterations, uint, "Number of times each operation is repeated.  Default value is 10000")
+URT_MODULE_PARAM_END()
+
+struct data
+{
+	skin_sensor_response *responses;
+	skin_sensor_response *baseline;
+	skin_sensor_response *min;
+	skin_sensor_response *max;
+	skin_sensor_response *out;
+	uint8_t *u8;
+	float *f;
+};
+
+static int start(struct data *d);
+static void body(struct data *d);
+static void stop(struct data *d);
+
+URT_GLUE(start, body, stop, struct data, interrupted, done)
+
+/* a simple LCG is enough to get responses all over the range */
+static inline skin_sensor_response random_response(uint32_t *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return *seed >> 16;
+}
+
+/*
+ * lengths checked against the scalar implementation.  Besides the empty and single response cases, these cover
+ * lengths around multiples of 8, 16 and 32, so both the vectorized loops and their scalar tails are exercised
+ */
+static const size_t check_lengths[] = {0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 23, 31, 32, 33, 47, 63, 64, 65, 100, 257};
+#define CHECK_LENGTH_MAX 257
+
+struct check_output
+{
+	uint8_t u8[CHECK_LENGTH_MAX];
+	float f[CHECK_LENGTH_MAX];
+	skin_sensor_response out[CHECK_LENGTH_MAX];
+	skin_sensor_response min[CHECK_LENGTH_MAX];
+	skin_sensor_response max[CHECK_LENGTH_MAX];
+	uint8_t mask[CHECK_LENGTH_MAX];
+	size_t above;
+};
+
+struct check_input
+{
+	/* one extra response, so unaligned input could also be checked */
+	skin_sensor_response responses[CHECK_LENGTH_MAX + 1];
+	skin_sensor_response baseline[CHECK_LENGTH_MAX + 1];
+	skin_sensor_response min[CHECK_LENGTH_MAX];
+	skin_sensor_response max[CHECK_LENGTH_MAX];
+};
+
+/*
+ * run all operations on the first count responses, starting from an offset.  The outputs are first filled with the
+ * same garbage for every implementation, so writes past count would be caught too
+ */
+static void check_run(struct check_output *o, const struct check_input *in, size_t offset, size_t count)
+{
+	memset(o, 0xa5, sizeof *o);
+	memcpy(o->min, in->min, sizeof o->min);
+	memcpy(o->max, in->max, sizeof o->max);
+
+	skin_responses_to_u8(o->u8, in->responses + offset, count);
+	skin_responses_to_float(o->f, in->responses + offset, count);
+	skin_responses_subtract_baseline(o->out, in->responses + offset, in->baseline + offset, count);
+	skin_responses_min_max(o->min, o->max, in->responses + offset, count);
+	o->above = skin_responses_threshold(o->mask, in->responses + offset, SKIN_SENSOR_RESPONSE_MAX / 2, count);
+}
+
+static const char *check_mismatch(const struct check_output *expected, const struct check_output *got)
+{
+	if (memcmp(expected->u8, got->u8, sizeof got->u8) != 0)
+		return "to_u8";
+	if (memcmp(expected->f, got->f, sizeof got->f) != 0)
+		return "to_float";
+	if (memcmp(expected->out, got->out, sizeof got->out) != 0)
+		return "subtract_baseline";
+	if (memcmp(expected->min, got->min, sizeof got->min) != 0
+			|| memcmp(expected->max, got->max, sizeof got->max) != 0)
+		return "min_max";
+	if (memcmp(expected->mask, got->mask, sizeof got->mask) != 0 || expected->above != got->above)
+		return "threshold";
+	return NULL;
+}
+
+/* check every supported implementation against the scalar one.  Returns non-zero if any of them doesn't match */
+static int check(void)
+{
+	struct check_input *in = NULL;
+	struct check_output *expected = NULL;
+	struct check_output *got = NULL;
+	enum skin_responses_simd simd;
+	unsigned int mismatches = 0;
+	uint32_t seed = 54321;
+	size_t i, l, offset;
+
+	in = urt_mem_new(sizeof *in);
+	expected = urt_mem_new(sizeof *expected);
+	got = urt_mem_new(sizeof *got);
+	if (in == NULL || expected == NULL || got == NULL)
+	{
+		urt_err("out of memory\n");
+		goto exit_no_mem;
+	}
+
+	/* random responses, with the extremes mixed in so saturation is checked too */
+	for (i = 0; i < CHECK_LENGTH_MAX + 1; ++i)
+	{
+		in->responses[i] = i % 13 == 0?SKIN_SENSOR_RESPONSE_MAX:i % 11 == 0?0:random_response(&seed);
+		in->baseline[i] = random_response(&seed);
+	}
+	for (i = 0; i < CHECK_LENGTH_MAX; ++i)
+	{
+		in->min[i] = random_response(&seed);
+		in->max[i] = random_response(&seed);
+	}
+
+	for (simd = SKIN_RESPONSES_SIMD_SSE2; simd <= SKIN_RESPONSES_SIMD_NEON; ++simd)
+	{
+		if (skin_responses_select_simd(simd))
+			continue;
+		urt_out("checking %s against scalar\n", skin_responses_simd_name());
+
+		for (l = 0; l < sizeof check_lengths / sizeof *check_lengths; ++l)
+			for (offset = 0; offset < 2; ++offset)
+			{
+				const char *mismatch;
+
+				skin_responses_select_simd(SKIN_RESPONSES_SIMD_SCALAR);
+				check_run(expected, in, offset, check_lengths[l]);
+				skin_responses_select_simd(simd);
+				check_run(got, in, offset, check_lengths[l]);
+
+				mismatch = check_mismatch(expected, got);
+				if (mismatch)
+				{
+					urt_err("MISMATCH: %s differs from scalar in %s with %zu responses (offset %zu)\n",
+							skin_responses_simd_name(), mismatch, check_lengths[l], offset);
+					++mismatches;
+				}
+			}
+	}
+
+	if (mismatches > 0)
+		urt_err("%u mismatches between SIMD implementations and the scalar one\n", mismatches);
+
+	urt_mem_delete(in);
+	urt_mem_delete(expected);
+	urt_mem_delete(got);
+	return mismatches > 0?EIO:0;
+exit_no_mem:
+	urt_mem_delete(in);
+	urt_mem_delete(expected);
+	urt_mem_delete(got);
+	return ENOMEM;
+}
+
+static void cleanup(struct data *d)
+{
+	urt_mem_delete(d->responses);
+	urt_mem_delete(d->baseline);
+	urt_mem_delete(d->min);
+	urt_mem_delete(d->max);
+	urt_mem_delete(d->out);
+	urt_mem_delete(d->u8);
+	urt_mem_delete(d->f);
+	urt_exit();
+}
+
+static int start(struct data *d)
+{
+	unsigned int i;
+	uint32_t seed = 12345;
+
+	*d = (struct data){0};
+
+	if (sensors == 0)
+		sensors = 1;
+	if (iterations == 0)
+		iterations = 1;
+
+	if (urt_init())
+		return EXIT_FAILURE;
+
+	d->responses = urt_mem_new(sensors * sizeof *d->responses);
+	d->baseline = urt_mem_new(sensors * sizeof *d->baseline);
+	d->min = urt_mem_new(sensors * sizeof *d->min);
+	d->max = urt_mem_new(sensors * sizeof *d->max);
+	d->out = urt_mem_new(sensors * sizeof *d->out);
+	d->u8 = urt_mem_new(sensors * sizeof *d->u8);
+	d->f = urt_mem_new(sensors * sizeof *d->f);
+	if (d->responses == NULL || d->baseline == NULL || d->min == NULL || d->max == NULL || d->out == NULL
+			|| d->u8 == NULL || d->f == NULL)
+		goto exit_no_mem;
+
+	for (i = 0; i < sensors; ++i)
+	{
+		d->responses[i] = random_response(&seed);
+		d->baseline[i] = d->responses[i] / 4;
+		d->min[i] = SKIN_SENSOR_RESPONSE_MAX;
+		d->max[i] = 0;
+	}
+
+	if (check())
+		goto exit_check_failed;
+
+	return 0;
+exit_check_failed:
+	cleanup(d);
+	return EXIT_FAILURE;
+exit_no_mem:
+	urt_err("out of memory\n");
+	cleanup(d);
+	return EXIT_FAILURE;
+}
+
+enum operation
+{
+	OP_TO_U8,
+	OP_TO_FLOAT,
+	OP_SUBTRACT_BASELINE,
+	OP_MIN_MAX,
+	OP_THRESHOLD,
+	OP_COUNT
+};
+
+static const char *operation_names[OP_COUNT] = {
+	[OP_TO_U8] = "to_u8",
+	[OP_TO_FLOAT] = "to_float",
+	[OP_SUBTRACT_BASELINE] = "subtract_baseline",
+	[OP_MIN_MAX] = "min_max",
+	[OP_THRESHOLD] = "threshold",
+};
+
+static void run_operation(struct data *d, enum operation op)
+{
+	switch (op)
+	{
+	case OP_TO_U8:
+		skin_responses_to_u8(d->u8, d->responses, sensors);
+		break;
+	case OP_TO_FLOAT:
+		skin_responses_to_float(d->f, d->responses, sensors);
+		break;
+	case OP_SUBTRACT_BASELINE:
+		skin_responses_subtract_baseline(d->out, d->responses, d->baseline, sensors);
+		break;
+	case OP_MIN_MAX:
+		skin_responses_min_max(d->min, d->max, d->responses, sensors);
+		break;
+	case OP_THRESHOLD:
+		skin_responses_threshold(d->u8, d->responses, SKIN_SENSOR_RESPONSE_MAX / 2, sensors);
+		break;
+	default:
+		break;
+	}
+}
+
+static void run(struct data *d, enum skin_responses_simd simd)
+{
+	unsigned int i;
+	enum operation op;
+
+	if (skin_responses_select_simd(simd))
+		return;
+
+	urt_out("%s:\n", skin_responses_simd_name());
+	for (op = 0; op < OP_COUNT && !interrupted; ++op)
+	{
+		urt_time start_time, elapsed;
+
+		/* warm up the caches */
+		run_operation(d, op);
+
+		start_time = urt_get_time();
+		for (i = 0; i < iterations; ++i)
+			run_operation(d, op);
+		elapsed = urt_get_time() - start_time;
+
+		urt_out("  %-18s %10llu ns/call, %8.1f Mresponses/s\n", operation_names[op],
+				(unsigned long long)(elapsed / iterations),
+				elapsed?(double)sensors * iterations * 1000 / elapsed:0.0);
+	}
+}
+
+static void body(struct data *d)
+{
+	enum skin_responses_simd simd;
+
+	urt_out("%u responses, %u iterations\n", sensors, iterations);
+
+	for (simd = SKIN_RESPONSES_SIMD_SCALAR; simd <= SKIN_RESPONSES_SIMD_NEON && !interrupted; ++simd)
+		run(d, simd);
+
+	done = 1;
+}
+
+static void stop(struct data *d)
+{
+	cleanup(d);
+}
@@ -29,7 +29,22 @@ URT_MODULE_LICENSE("GPL");
 URT_MODULE_AUTHOR("Shahbaz Youssefi");
 URT_MODULE_DESCRIPTION("Skin Information Retriever");
 
+/*
+ * By default, the information is printed once.  In watch mode, the statistics of the writers and readers are
+ * sampled periodically and their frame rates, execution time percentiles, swap skips and missed frames since the
+ * previous sample are printed, similar to top.
+ *
+ * With the json and csv formats, a snapshot of the skin kernel is printed instead, once or in watch mode at every
+ * interval.  In json, every snapshot is a single line.  In csv, every snapshot adds a row per writer, reader and
+ * sensor type of each driver.  The statistics are cumulative since the start of each writer and reader, so rates
+ * can be calculated from consecutive snapshots.
+ */
+static unsigned int watch = 0;
+static char *format = NULL;
+
 URT_MODULE_PARAM_START()
+URT_MODULE_PARAM(watch, uint, "Refresh interval in milliseconds to watch the statistics (0 to print once).  Default value is 0")
+URT_MODULE_PARAM(format, charp, "Output format; one of table, json or csv.  Default value is 'table'")
 URT_MODULE_PARAM_END()
 
 struct data
@@ -67,9 +82,193 @@ exit_no_skin:
 	return EXIT_FAILURE;
 }
 
+static void print_json_string(const char *str)
+{
+	urt_out_cont("\"");
+	for (; *str; ++str)
+		if (*str == '"' || *str == '\\')
+			urt_out_cont("\\%c", *str);
+		else if ((unsigned char)*str < 0x20)
+			urt_out_cont("\\u%04x", (unsigned int)(unsigned char)*str);
+		else
+			urt_out_cont("%c", *str);
+	urt_out_cont("\"");
+}
+
+static const char *sensor_type_name(skin_sensor_type_id type)
+{
+	const char *name = skin_get_sensor_type_name(type);
+	return name?name:"";
+}
+
+static void print_json(struct skin_kernel_snapshot *s)
+{
+	size_t i, j, r = 0;
+
+	urt_out_cont("{\"time\":%llu,\"writers\":[", (unsigned long long)s->time);
+	for (i = 0; i < s->writer_count; ++i)
+	{
+		struct skin_writer_snapshot *w = &s->writers[i];
+
+		urt_out_cont("%s{\"index\":%u,\"name\":", i == 0?"":",", w->index);
+		print_json_string(w->name);
+		if (!w->is_driver)
+			urt_out_cont(",\"driver\":null");
+		else
+			urt_out_cont(",\"driver\":%u", w->driver_index);
+		urt_out_cont(",\"active\":%s,\"paused\":%s,\"bad\":%s,"
+				"\"buffer_size\":%zu,\"buffer_count\":%u,\"lock_free\":%s,\"history\":%u,"
+				"\"period\":%llu,\"readers_attached\":%u,\"frame_count\":%llu,",
+				w->active?"true":"false", w->paused?"true":"false", w->bad?"true":"false",
+				w->buffer_size, w->buffer_count, w->lock_free?"true":"false", w->history,
+				(unsigned long long)w->period, w->readers_attached, (unsigned long long)w->frame_count);
+		urt_out_cont("\"start_time\":%llu,\"write_count\":%llu,\"accumulated_write_time\":%llu,"
+				"\"best_write_time\":%llu,\"worst_write_time\":%llu,\"p50_write_time\":%llu,"
+				"\"p99_write_time\":%llu,\"swap_skips\":%llu,\"swap_count\":%llu,\"readers\":[",
+				(unsigned long long)w->stats.start_time, (unsigned long long)w->stats.write_count,
+				(unsigned long long)w->stats.accumulated_write_time,
+				(unsigned long long)w->stats.best_write_time, (unsigned long long)w->stats.worst_write_time,
+				(unsigned long long)skin_histogram_percentile(&w->write_times, 50000),
+				(unsigned long long)skin_histogram_percentile(&w->write_times, 99000),
+				(unsigned long long)w->stats.swap_skips, (unsigned long long)w->stats.swap_count);
+
+		/* the readers of each writer come right after those of the previous writer */
+		for (j = 0; r < s->reader_count && s->readers[r].writer_index == w->index; ++r, ++j)
+		{
+			struct skin_reader_snapshot *rd = &s->readers[r];
+
+			urt_out_cont("%s{\"slot\":%u,\"start_time\":%llu,\"read_count\":%llu,\"accumulated_read_time\":%llu,"
+					"\"best_read_time\":%llu,\"worst_read_time\":%llu,\"p50_read_time\":%llu,"
+					"\"p99_read_time\":%llu,\"frames_missed\":%llu,\"frames_dropped\":%llu,"
+					"\"stale_wakeups\":%llu,\"lock_retries\":%llu}",
+					j == 0?"":",", rd->slot, (unsigned long long)rd->stats.start_time,
+					(unsigned long long)rd->stats.read_count,
+					(unsigned long long)rd->stats.accumulated_read_time,
+					(unsigned long long)rd->stats.best_read_time, (unsigned long long)rd->stats.worst_read_time,
+					(unsigned long long)skin_histogram_percentile(&rd->read_times, 50000),
+					(unsigned long long)skin_histogram_percentile(&rd->read_times, 99000),
+					(unsigned long long)rd->stats.frames_missed, (unsigned long long)rd->stats.frames_dropped,
+					(unsigned long long)rd->stats.stale_wakeups, (unsigned long long)rd->stats.lock_retries);
+		}
+		urt_out_cont("]}");
+	}
+
+	urt_out_cont("],\"drivers\":[");
+	for (i = 0; i < s->driver_count; ++i)
+	{
+		struct skin_driver_snapshot *dr = &s->drivers[i];
+
+		urt_out_cont("%s{\"index\":%u,\"writer\":%u,\"active\":%s,\"users_attached\":%u,"
+				"\"patch_count\":%u,\"module_count\":%u,\"sensor_count\":%u,\"sensor_types\":[",
+				i == 0?"":",", dr->index, dr->writer_index, dr->active?"true":"false", dr->users_attached,
+				dr->attr.patch_count, dr->attr.module_count, dr->attr.sensor_count);
+		for (j = 0; j < dr->sensor_type_count; ++j)
+		{
+			struct skin_sensor_type_snapshot *st = &s->sensor_types[dr->sensor_types_begin + j];
+
+			urt_out_cont("%s{\"type\":%u,\"name\":", j == 0?"":",", st->type);
+			print_json_string(sensor_type_name(st->type));
+			urt_out_cont(",\"sensor_count\":%u}", st->sensor_count);
+		}
+		urt_out_cont("]}");
+	}
+	urt_out_cont("]}\n");
+}
+
+static void print_csv_header(void)
+{
+	urt_out_cont("time,kind,index,writer,name,period,readers_attached,bad,count,accumulated_time,best_time,worst_time,"
+			"p50_time,p99_time,swap_skips,frames_missed,frames_dropped,sensor_type,sensor_count\n");
+}
+
+static void print_csv(struct skin_kernel_snapshot *s)
+{
+	size_t i, j;
+	unsigned long long t = s->time;
+
+	for (i = 0; i < s->writer_count; ++i)
+	{
+		struct skin_writer_snapshot *w = &s->writers[i];
+
+		/* writer names can't contain quotes, so quoting them suffices */
+		urt_out_cont("%llu,writer,%u,%u,\"%s\",%llu,%u,%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu,,,,\n", t,
+				w->index, w->index, w->name, (unsigned long long)w->period, w->readers_attached, w->bad,
+				(unsigned long long)w->stats.write_count, (unsigned long long)w->stats.accumulated_write_time,
+				(unsigned long long)w->stats.best_write_time, (unsigned long long)w->stats.worst_write_time,
+				(unsigned long long)skin_histogram_percentile(&w->write_times, 50000),
+				(unsigned long long)skin_histogram_percentile(&w->write_times, 99000),
+				(unsigned long long)w->stats.swap_skips);
+	}
+
+	for (i = 0; i < s->reader_count; ++i)
+	{
+		struct skin_reader_snapshot *r = &s->readers[i];
+
+		urt_out_cont("%llu,reader,%u,%u,,,,,%llu,%llu,%llu,%llu,%llu,%llu,,%llu,%llu,,\n", t,
+				r->slot, r->writer_index,
+				(unsigned long long)r->stats.read_count, (unsigned long long)r->stats.accumulated_read_time,
+				(unsigned long long)r->stats.best_read_time, (unsigned long long)r->stats.worst_read_time,
+				(unsigned long long)skin_histogram_percentile(&r->read_times, 50000),
+				(unsigned long long)skin_histogram_percentile(&r->read_times, 99000),
+				(unsigned long long)r->stats.frames_missed, (unsigned long long)r->stats.frames_dropped);
+	}
+
+	for (i = 0; i < s->driver_count; ++i)
+	{
+		struct skin_driver_snapshot *dr = &s->drivers[i];
+
+		for (j = 0; j < dr->sensor_type_count; ++j)
+		{
+			struct skin_sensor_type_snapshot *st = &s->sensor_types[dr->sensor_types_begin + j];
+
+			urt_out_cont("%llu,sensor_type,%u,%u,\"%s\",,%u,,,,,,,,,,,%u,%u\n", t,
+					dr->index, dr->writer_index, sensor_type_name(st->type), dr->users_attached,
+					st->type, st->sensor_count);
+		}
+	}
+}
+
+static void export_snapshots(struct data *d, bool csv)
+{
+	struct skin_kernel_snapshot snapshot = {0};
+	int err;
+
+	if (csv)
+		print_csv_header();
+
+	do
+	{
+		if ((err = skin_get_kernel_snapshot(d->skin, &snapshot)))
+		{
+			urt_err("failed to take a snapshot of the skin kernel (error: %d)\n", err);
+			break;
+		}
+
+		if (csv)
+			print_csv(&snapshot);
+		else
+			print_json(&snapshot);
+
+		if (watch == 0)
+			break;
+		urt_sleep(watch * 1000000llu);
+	} while (!interrupted);
+
+	skin_kernel_snapshot_free(&snapshot);
+}
+
 static void body(struct data *d)
 {
-	skin_internal_print_info(d->skin);
+	if (format && strcmp(format, "json") == 0)
+		export_snapshots(d, false);
+	else if (format && strcmp(format, "csv") == 0)
+		export_snapshots(d, true);
+	else if (format && strcmp(format, "table") != 0)
+		urt_err("unknown format '%s'\n", format);
+	else if (watch > 0)
+		skin_internal_watch_info(d->skin, watch, &interrupted);
+	else
+		skin_internal_print_info(d->skin);
 	done = 1;
 }
 